@@ -8,7 +8,7 @@ public class Phanto : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 	
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "NavigationSystem", "OculusXRHMD", "OculusXRScene", "OculusXRAnchors", "AIModule" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "NavigationSystem", "OculusXRHMD", "OculusXRScene", "OculusXRAnchors", "AIModule", "GameplayTasks", "Niagara", "ProceduralMeshComponent" });
         
         // Required for OpenXR support
         PublicIncludePathModuleNames.AddRange(new string[] { "OpenXRHMD" });
@@ -17,6 +17,9 @@ public class Phanto : ModuleRules
         PrivateIncludePaths.Add($"{GetModuleDirectory("OculusXRAnchors")}/Public");
         PrivateIncludePaths.Add($"{GetModuleDirectory("OculusXRHMD")}/Public");
 
+        // Benchmark reports
+        PrivateDependencyModuleNames.AddRange(new string[] { "Json", "JsonUtilities" });
+
         //PrivateIncludePathModuleNames.AddRange(new string[] { "NavigationSystem" });
 
         //      PrivateDependencyModuleNames.AddRange(new string[] { "NavigationSystem" });
@@ -3,4 +3,6 @@
 #include "Phanto.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogPhanto);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Phanto, "Phanto" );
@@ -4,3 +4,5 @@
 
 #include "CoreMinimal.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogPhanto, Log, All);
+DECLARE_STATS_GROUP(TEXT("Phanto"), STATGROUP_Phanto, STATCAT_Advanced);
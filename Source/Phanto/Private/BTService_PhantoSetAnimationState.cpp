@@ -0,0 +1,146 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "BTService_PhantoSetAnimationState.h"
+
+#include "AIController.h"
+#include "Animation/AnimInstance.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "PhantoAnimStateBridgeComponent.h"
+
+UBTService_PhantoSetAnimationState::UBTService_PhantoSetAnimationState()
+{
+	NodeName = TEXT("Phanto Set Animation State");
+	bNotifyBecomeRelevant = true;
+	bNotifyTick = true;
+	Interval = 0.1f;
+	RandomDeviation = 0.02f;
+	AttackingKey.SelectedKeyName = TEXT("IsAttacking");
+	AttackingKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_PhantoSetAnimationState, AttackingKey));
+	AttackingKey.AllowNoneAsValue(true);
+}
+
+void UBTService_PhantoSetAnimationState::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (auto BlackboardAsset = GetBlackboardAsset())
+		AttackingKey.ResolveSelectedKey(*BlackboardAsset);
+}
+
+void UBTService_PhantoSetAnimationState::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	Super::OnBecomeRelevant(OwnerComp, NodeMemory);
+
+	auto Memory = CastInstanceNodeMemory<FBTPhantoAnimationStateMemory>(NodeMemory);
+	Memory->Target = nullptr;
+	Memory->Property = nullptr;
+	Memory->LastState = INDEX_NONE;
+	Memory->bBridged = false;
+
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Pawn = Controller ? Controller->GetPawn() : nullptr;
+	if (!Pawn)
+		return;
+
+	if (bUseAnimStateBridge)
+	{
+		// A bridge already on the pawn keeps its own settings.
+		auto Bridge = Pawn->FindComponentByClass<UPhantoAnimStateBridgeComponent>();
+		if (!Bridge)
+		{
+			Bridge = NewObject<UPhantoAnimStateBridgeComponent>(Pawn);
+			Bridge->AnimStateProperty = AnimStateProperty;
+			Bridge->MovingSpeed = MovingSpeed;
+			Bridge->IdleState = IdleState;
+			Bridge->MovingState = MovingState;
+			Bridge->FallingState = FallingState;
+			if (AttackingKey.IsSet())
+				Bridge->KeyStates.Add({ AttackingKey.SelectedKeyName, AttackingState });
+			Pawn->AddInstanceComponent(Bridge);
+			Bridge->RegisterComponent();
+		}
+		Bridge->SetBlackboard(OwnerComp.GetBlackboardComponent());
+
+		Memory->bBridged = true;
+		SetNextTickTime(NodeMemory, FLT_MAX);
+		return;
+	}
+
+	auto Mesh = Pawn->FindComponentByClass<USkeletalMeshComponent>();
+	auto AnimInstance = Mesh ? Mesh->GetAnimInstance() : nullptr;
+	for (UObject* Candidate : { static_cast<UObject*>(AnimInstance), static_cast<UObject*>(Pawn) })
+	{
+		if (auto Property = Candidate ? UPhantoAnimStateBridgeComponent::FindAnimStateProperty(*Candidate, AnimStateProperty) : nullptr)
+		{
+			Memory->Target = Candidate;
+			Memory->Property = Property;
+			break;
+		}
+	}
+}
+
+void UBTService_PhantoSetAnimationState::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	auto Memory = CastInstanceNodeMemory<FBTPhantoAnimationStateMemory>(NodeMemory);
+	if (Memory->bBridged)
+	{
+		SetNextTickTime(NodeMemory, FLT_MAX);
+		return;
+	}
+
+	auto Target = Memory->Target.Get();
+	if (!Target || !Memory->Property)
+		return;
+
+	auto const State = GetAnimationState(OwnerComp);
+	if (State == Memory->LastState)
+		return;
+
+	Memory->LastState = State;
+	Memory->Property->SetIntPropertyValue(Memory->Property->ContainerPtrToValuePtr<void>(Target), int64(State));
+}
+
+uint8 UBTService_PhantoSetAnimationState::GetAnimationState(UBehaviorTreeComponent& OwnerComp) const
+{
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	if (Blackboard && AttackingKey.IsSet() && Blackboard->GetValue<UBlackboardKeyType_Bool>(AttackingKey.GetSelectedKeyID()))
+		return AttackingState;
+
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Pawn = Controller ? Controller->GetPawn() : nullptr;
+	auto Movement = Pawn ? Pawn->GetMovementComponent() : nullptr;
+	if (!Movement)
+		return IdleState;
+
+	if (Movement->IsFalling())
+		return FallingState;
+
+	return Movement->Velocity.SizeSquared() > FMath::Square(MovingSpeed) ? MovingState : IdleState;
+}
+
+uint16 UBTService_PhantoSetAnimationState::GetInstanceMemorySize() const
+{
+	return sizeof(FBTPhantoAnimationStateMemory);
+}
+
+void UBTService_PhantoSetAnimationState::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTPhantoAnimationStateMemory>(NodeMemory, InitType);
+}
+
+void UBTService_PhantoSetAnimationState::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTPhantoAnimationStateMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTService_PhantoSetAnimationState::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nWrites %s"), *Super::GetStaticDescription(), *AnimStateProperty.ToString());
+}
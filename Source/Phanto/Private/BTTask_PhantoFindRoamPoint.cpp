@@ -0,0 +1,37 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "BTTask_PhantoFindRoamPoint.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "PhantoRoamPointSubsystem.h"
+
+UBTTask_PhantoFindRoamPoint::UBTTask_PhantoFindRoamPoint()
+{
+	NodeName = TEXT("Find Roam Point");
+	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantoFindRoamPoint, BlackboardKey));
+}
+
+EBTNodeResult::Type UBTTask_PhantoFindRoamPoint::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Pawn = Controller ? Controller->GetPawn() : nullptr;
+	auto Subsystem = Pawn ? Pawn->GetWorld()->GetSubsystem<UPhantoRoamPointSubsystem>() : nullptr;
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	if (!Subsystem || !Blackboard)
+		return EBTNodeResult::Failed;
+
+	FVector Location;
+	if (!Subsystem->GetRandomReachableRoamPoint(Pawn->GetNavAgentLocation(), Radius, Location))
+		return EBTNodeResult::Failed;
+
+	Blackboard->SetValue<UBlackboardKeyType_Vector>(GetSelectedBlackboardKey(), Location);
+	return EBTNodeResult::Succeeded;
+}
+
+FString UBTTask_PhantoFindRoamPoint::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nRadius: %.0f"), *Super::GetStaticDescription(), Radius);
+}
@@ -0,0 +1,108 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "BTTask_PhantoMoveTo.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "PhantoPathRequestSubsystem.h"
+
+UBTTask_PhantoMoveTo::UBTTask_PhantoMoveTo()
+{
+	NodeName = TEXT("Phanto Move To");
+	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantoMoveTo, BlackboardKey));
+	BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantoMoveTo, BlackboardKey), AActor::StaticClass());
+}
+
+EBTNodeResult::Type UBTTask_PhantoMoveTo::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	auto Memory = CastInstanceNodeMemory<FBTPhantoMoveToMemory>(NodeMemory);
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Pawn = Controller ? Controller->GetPawn() : nullptr;
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	auto Subsystem = OwnerComp.GetWorld()->GetSubsystem<UPhantoPathRequestSubsystem>();
+	if (!Pawn || !Blackboard || !Subsystem)
+		return EBTNodeResult::Failed;
+
+	FVector Goal;
+	if (!Blackboard->GetLocationFromEntry(GetSelectedBlackboardKey(), Goal))
+		return EBTNodeResult::Failed;
+
+	Memory->MoveRequestId = FAIRequestID::InvalidRequest;
+	Memory->PathRequestId = Subsystem->RequestPath(Controller->GetNavAgentPropertiesRef(), Pawn->GetNavAgentLocation(), Goal, Controller,
+		FPhantoPathRequestDelegate::CreateUObject(this, &UBTTask_PhantoMoveTo::HandlePathFound, TWeakObjectPtr<UBehaviorTreeComponent>(&OwnerComp)));
+	return EBTNodeResult::InProgress;
+}
+
+EBTNodeResult::Type UBTTask_PhantoMoveTo::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	auto Memory = CastInstanceNodeMemory<FBTPhantoMoveToMemory>(NodeMemory);
+	if (Memory->PathRequestId)
+	{
+		if (auto Subsystem = OwnerComp.GetWorld()->GetSubsystem<UPhantoPathRequestSubsystem>())
+			Subsystem->CancelRequest(Memory->PathRequestId);
+		Memory->PathRequestId = 0;
+	}
+	else if (Memory->MoveRequestId.IsValid())
+	{
+		auto Controller = OwnerComp.GetAIOwner();
+		if (auto PathFollowing = Controller ? Controller->GetPathFollowingComponent() : nullptr)
+			PathFollowing->AbortMove(*this, FPathFollowingResultFlags::OwnerFinished, Memory->MoveRequestId, EPathFollowingVelocityMode::Keep);
+	}
+
+	return EBTNodeResult::Aborted;
+}
+
+uint16 UBTTask_PhantoMoveTo::GetInstanceMemorySize() const
+{
+	return sizeof(FBTPhantoMoveToMemory);
+}
+
+void UBTTask_PhantoMoveTo::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTPhantoMoveToMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_PhantoMoveTo::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTPhantoMoveToMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTTask_PhantoMoveTo::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nAcceptable radius: %.0f"), *Super::GetStaticDescription(), AcceptableRadius);
+}
+
+void UBTTask_PhantoMoveTo::HandlePathFound(uint32 RequestId, FNavPathSharedPtr Path, TWeakObjectPtr<UBehaviorTreeComponent> WeakOwnerComp)
+{
+	auto OwnerComp = WeakOwnerComp.Get();
+	if (!OwnerComp || OwnerComp->GetTaskStatus(this) != EBTTaskStatus::Active)
+		return;
+
+	auto Memory = CastInstanceNodeMemory<FBTPhantoMoveToMemory>(OwnerComp->GetNodeMemory(this, OwnerComp->FindInstanceContainingNode(this)));
+	if (!Memory || Memory->PathRequestId != RequestId)
+		return;
+
+	Memory->PathRequestId = 0;
+
+	auto Controller = OwnerComp->GetAIOwner();
+	if (!Path || !Controller)
+	{
+		FinishLatentTask(*OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+
+	FAIMoveRequest MoveRequest(Path->GetEndLocation());
+	MoveRequest.SetAcceptanceRadius(AcceptableRadius);
+	Memory->MoveRequestId = Controller->RequestMove(MoveRequest, Path);
+	if (!Memory->MoveRequestId.IsValid())
+	{
+		FinishLatentTask(*OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+
+	// The default OnMessage finishes the task with the result of the move.
+	WaitForMessage(*OwnerComp, UBrainComponent::AIMessage_MoveFinished, Memory->MoveRequestId);
+}
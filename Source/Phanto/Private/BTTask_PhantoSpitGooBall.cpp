@@ -0,0 +1,121 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "BTTask_PhantoSpitGooBall.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhantoProjectileManager.h"
+
+UBTTask_PhantoSpitGooBall::UBTTask_PhantoSpitGooBall()
+{
+	NodeName = TEXT("Phanto Spit Goo Ball");
+	bNotifyTick = true;
+	bNotifyTaskFinished = true;
+	BlackboardKey.SelectedKeyName = TEXT("Target");
+	BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantoSpitGooBall, BlackboardKey), AActor::StaticClass());
+	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantoSpitGooBall, BlackboardKey));
+}
+
+EBTNodeResult::Type UBTTask_PhantoSpitGooBall::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	if (!Controller || !Controller->GetPawn() || !Blackboard)
+		return EBTNodeResult::Failed;
+
+	if (BlackboardKey.SelectedKeyType == UBlackboardKeyType_Object::StaticClass())
+	{
+		auto Target = Cast<AActor>(Blackboard->GetValue<UBlackboardKeyType_Object>(GetSelectedBlackboardKey()));
+		if (!Target)
+			return EBTNodeResult::Failed;
+		Controller->SetFocus(Target, EAIFocusPriority::Gameplay);
+	}
+	else
+	{
+		FVector Goal;
+		if (!Blackboard->GetLocationFromEntry(GetSelectedBlackboardKey(), Goal))
+			return EBTNodeResult::Failed;
+		Controller->SetFocalPoint(Goal, EAIFocusPriority::Gameplay);
+	}
+
+	auto Memory = CastInstanceNodeMemory<FBTPhantoSpitGooBallMemory>(NodeMemory);
+	Memory->ElapsedTime = 0;
+	Memory->bFired = false;
+	return EBTNodeResult::InProgress;
+}
+
+void UBTTask_PhantoSpitGooBall::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	auto Memory = CastInstanceNodeMemory<FBTPhantoSpitGooBallMemory>(NodeMemory);
+	Memory->ElapsedTime += DeltaSeconds;
+
+	if (!Memory->bFired && Memory->ElapsedTime >= SpitDelay)
+	{
+		Memory->bFired = true;
+		if (!Spit(OwnerComp))
+		{
+			FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+			return;
+		}
+	}
+
+	if (Memory->ElapsedTime >= FMath::Max(Duration, SpitDelay))
+		FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+}
+
+bool UBTTask_PhantoSpitGooBall::Spit(UBehaviorTreeComponent& OwnerComp) const
+{
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Pawn = Controller ? Controller->GetPawn() : nullptr;
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	auto ProjectileManager = APhantoProjectileManager::GetProjectileManager(Pawn);
+	if (!Pawn || !Blackboard || !ProjectileManager)
+		return false;
+
+	FVector Goal;
+	if (!Blackboard->GetLocationFromEntry(GetSelectedBlackboardKey(), Goal))
+		return false;
+
+	auto Mesh = Pawn->FindComponentByClass<USkeletalMeshComponent>();
+	auto const Start = Mesh && Mesh->DoesSocketExist(MouthSocket) ? Mesh->GetSocketLocation(MouthSocket) : Pawn->GetActorLocation();
+
+	// Lob it when the target is reachable at LaunchSpeed, else spit straight at it.
+	FVector Velocity;
+	auto const GravityZ = Pawn->GetWorld()->GetGravityZ() * ProjectileManager->GravityScale;
+	if (!UGameplayStatics::SuggestProjectileVelocity(Pawn, Velocity, Start, Goal, LaunchSpeed, false, 0, GravityZ, ESuggestProjVelocityTraceOption::DoNotTrace))
+		Velocity = (Goal - Start).GetSafeNormal() * LaunchSpeed;
+
+	return ProjectileManager->FireProjectile(Start, Velocity, Pawn);
+}
+
+void UBTTask_PhantoSpitGooBall::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	if (auto Controller = OwnerComp.GetAIOwner())
+		Controller->ClearFocus(EAIFocusPriority::Gameplay);
+
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+uint16 UBTTask_PhantoSpitGooBall::GetInstanceMemorySize() const
+{
+	return sizeof(FBTPhantoSpitGooBallMemory);
+}
+
+void UBTTask_PhantoSpitGooBall::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTPhantoSpitGooBallMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_PhantoSpitGooBall::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTPhantoSpitGooBallMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTTask_PhantoSpitGooBall::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nLaunch speed: %.0f after %.2fs"), *Super::GetStaticDescription(), LaunchSpeed, SpitDelay);
+}
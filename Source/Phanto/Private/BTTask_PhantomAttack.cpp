@@ -0,0 +1,113 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "BTTask_PhantomAttack.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+
+UBTTask_PhantomAttack::UBTTask_PhantomAttack()
+{
+	NodeName = TEXT("Phantom Attack");
+	bNotifyTick = true;
+	bNotifyTaskFinished = true;
+	BlackboardKey.SelectedKeyName = TEXT("Target");
+	BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantomAttack, BlackboardKey), AActor::StaticClass());
+	AttackingKey.SelectedKeyName = TEXT("IsAttacking");
+	AttackingKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantomAttack, AttackingKey));
+	AttackingKey.AllowNoneAsValue(true);
+}
+
+void UBTTask_PhantomAttack::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (auto BlackboardAsset = GetBlackboardAsset())
+		AttackingKey.ResolveSelectedKey(*BlackboardAsset);
+}
+
+AActor* UBTTask_PhantomAttack::GetTargetInRange(UBehaviorTreeComponent& OwnerComp) const
+{
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Pawn = Controller ? Controller->GetPawn() : nullptr;
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	if (!Pawn || !Blackboard)
+		return nullptr;
+
+	auto Target = Cast<AActor>(Blackboard->GetValue<UBlackboardKeyType_Object>(GetSelectedBlackboardKey()));
+	if (!Target || Pawn->GetDistanceTo(Target) > AttackRange)
+		return nullptr;
+
+	return Target;
+}
+
+EBTNodeResult::Type UBTTask_PhantomAttack::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	auto Target = GetTargetInRange(OwnerComp);
+	if (!Target)
+		return EBTNodeResult::Failed;
+
+	auto Memory = CastInstanceNodeMemory<FBTPhantomAttackMemory>(NodeMemory);
+	Memory->ElapsedTime = 0;
+	Memory->bDamageApplied = false;
+	OwnerComp.GetAIOwner()->SetFocus(Target, EAIFocusPriority::Gameplay);
+	if (AttackingKey.IsSet())
+		OwnerComp.GetBlackboardComponent()->SetValue<UBlackboardKeyType_Bool>(AttackingKey.GetSelectedKeyID(), true);
+	return EBTNodeResult::InProgress;
+}
+
+void UBTTask_PhantomAttack::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	auto Memory = CastInstanceNodeMemory<FBTPhantomAttackMemory>(NodeMemory);
+	Memory->ElapsedTime += DeltaSeconds;
+
+	if (!Memory->bDamageApplied && Memory->ElapsedTime >= HitDelay)
+	{
+		Memory->bDamageApplied = true;
+		if (auto Target = GetTargetInRange(OwnerComp))
+		{
+			auto Controller = OwnerComp.GetAIOwner();
+			UGameplayStatics::ApplyDamage(Target, Damage, Controller, Controller->GetPawn(), DamageType);
+		}
+	}
+
+	if (Memory->ElapsedTime >= FMath::Max(Duration, HitDelay))
+		FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+}
+
+void UBTTask_PhantomAttack::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	if (auto Controller = OwnerComp.GetAIOwner())
+		Controller->ClearFocus(EAIFocusPriority::Gameplay);
+
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	if (Blackboard && AttackingKey.IsSet())
+		Blackboard->SetValue<UBlackboardKeyType_Bool>(AttackingKey.GetSelectedKeyID(), false);
+
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+uint16 UBTTask_PhantomAttack::GetInstanceMemorySize() const
+{
+	return sizeof(FBTPhantomAttackMemory);
+}
+
+void UBTTask_PhantomAttack::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTPhantomAttackMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_PhantomAttack::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTPhantomAttackMemory>(NodeMemory, CleanupType);
+}
+
+FString UBTTask_PhantomAttack::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nRange: %.0f, damage: %.0f after %.2fs"), *Super::GetStaticDescription(), AttackRange, Damage, HitDelay);
+}
@@ -0,0 +1,41 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "BTTask_PhantomRoam.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "PhantoRoamPointSubsystem.h"
+
+UBTTask_PhantomRoam::UBTTask_PhantomRoam()
+{
+	NodeName = TEXT("Phantom Roam");
+	BlackboardKey.SelectedKeyName = TEXT("TargetLocation");
+
+	// The roam point is written to the key, so only vectors make sense here.
+	BlackboardKey.AllowedTypes.Reset();
+	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_PhantomRoam, BlackboardKey));
+}
+
+EBTNodeResult::Type UBTTask_PhantomRoam::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	auto Controller = OwnerComp.GetAIOwner();
+	auto Pawn = Controller ? Controller->GetPawn() : nullptr;
+	auto Subsystem = Pawn ? Pawn->GetWorld()->GetSubsystem<UPhantoRoamPointSubsystem>() : nullptr;
+	auto Blackboard = OwnerComp.GetBlackboardComponent();
+	if (!Subsystem || !Blackboard)
+		return EBTNodeResult::Failed;
+
+	FVector Location;
+	if (!Subsystem->GetRandomReachableRoamPoint(Pawn->GetNavAgentLocation(), Radius, Location))
+		return EBTNodeResult::Failed;
+
+	Blackboard->SetValue<UBlackboardKeyType_Vector>(GetSelectedBlackboardKey(), Location);
+	return Super::ExecuteTask(OwnerComp, NodeMemory);
+}
+
+FString UBTTask_PhantomRoam::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nRadius: %.0f"), *Super::GetStaticDescription(), Radius);
+}
@@ -3,3 +3,41 @@
 
 #include "BlueprintXRSceneAnchorComponent.h"
 
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "PhantoSceneAnchorRegistry.h"
+
+void UBlueprintXRSceneAnchorComponent::RefreshRegistration()
+{
+	if (auto Registry = GetWorld() ? GetWorld()->GetSubsystem<UPhantoSceneAnchorRegistry>() : nullptr)
+		Registry->UpdateAnchor(this);
+}
+
+void UBlueprintXRSceneAnchorComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (auto Registry = GetWorld()->GetSubsystem<UPhantoSceneAnchorRegistry>())
+		Registry->RegisterAnchor(this);
+
+	// Anchors are moved by tracking, which moves their actor rather than this component.
+	if (auto Root = GetOwner()->GetRootComponent())
+		TransformUpdatedHandle = Root->TransformUpdated.AddUObject(this, &UBlueprintXRSceneAnchorComponent::HandleTransformUpdated);
+}
+
+void UBlueprintXRSceneAnchorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto Root = GetOwner()->GetRootComponent())
+		Root->TransformUpdated.Remove(TransformUpdatedHandle);
+
+	if (auto Registry = GetWorld()->GetSubsystem<UPhantoSceneAnchorRegistry>())
+		Registry->UnregisterAnchor(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UBlueprintXRSceneAnchorComponent::HandleTransformUpdated(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport)
+{
+	RefreshRegistration();
+}
@@ -0,0 +1,52 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "FindFlightPathAsyncAction.h"
+
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "PhantoFlightNavigationSubsystem.h"
+#include "PhantoFlightOctree.h"
+
+UFindFlightPathAsyncAction* UFindFlightPathAsyncAction::FindFlightPath(UObject const * WorldContext, FVector Start, FVector End)
+{
+	auto Action = NewObject<UFindFlightPathAsyncAction>();
+	Action->WorldContext = WorldContext;
+	Action->Start = Start;
+	Action->End = End;
+	Action->RegisterWithGameInstance(WorldContext);
+	return Action;
+}
+
+void UFindFlightPathAsyncAction::Activate()
+{
+	auto World = GEngine->GetWorldFromContextObject(WorldContext.Get(), EGetWorldErrorMode::LogAndReturnNull);
+	auto Subsystem = World ? World->GetSubsystem<UPhantoFlightNavigationSubsystem>() : nullptr;
+	auto Octree = Subsystem ? Subsystem->GetOctree() : nullptr;
+	if (!Octree)
+	{
+		Finish(false, {});
+		return;
+	}
+
+	AsyncPool(*GThreadPool, [Octree, Start = Start, End = End, WeakThis = TWeakObjectPtr<UFindFlightPathAsyncAction>(this)]
+	{
+		TArray<FVector> Path;
+		auto const bFound = Octree->FindPath(Start, End, Path);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bFound, Path = MoveTemp(Path)]
+		{
+			if (auto This = WeakThis.Get())
+				This->Finish(bFound, Path);
+		});
+	});
+}
+
+void UFindFlightPathAsyncAction::Finish(bool bFound, const TArray<FVector>& Path)
+{
+	if (bFound)
+		Found.Broadcast(Path);
+	else
+		Failed.Broadcast(Path);
+	SetReadyToDestroy();
+}
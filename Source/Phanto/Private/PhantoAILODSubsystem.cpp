@@ -0,0 +1,326 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoAILODSubsystem.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "Phanto.h"
+#include "PhantoVectorMath.h"
+
+DECLARE_CYCLE_STAT(TEXT("AI LOD Classify"), STAT_PhantoAILODClassify, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOD High"), STAT_PhantoAILODHigh, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOD Medium"), STAT_PhantoAILODMedium, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOD Low"), STAT_PhantoAILODLow, STATGROUP_Phanto);
+
+UPhantoAILODSubsystem::UPhantoAILODSubsystem()
+{
+	TierSettings.SetNum(3);
+
+	auto& Medium = TierSettings[int32(EPhantoAILODTier::Medium)];
+	Medium.BehaviorTreeInterval = 0.1f;
+	Medium.PathFollowingInterval = 0.05f;
+	Medium.AnimationInterval = 1.f / 30;
+
+	auto& Low = TierSettings[int32(EPhantoAILODTier::Low)];
+	Low.BehaviorTreeInterval = 0.3f;
+	Low.PathFollowingInterval = 0.15f;
+	Low.AnimationInterval = 0.1f;
+}
+
+void UPhantoAILODSubsystem::RegisterAgent(APawn* Pawn)
+{
+	if (!Pawn || Agents.ContainsByPredicate([Pawn](const FAgent& Agent) { return Agent.Pawn == Pawn; }))
+		return;
+
+	auto& Agent = Agents.AddDefaulted_GetRef();
+	Agent.Pawn = Pawn;
+	Agent.TierTime = GetWorld()->GetTimeSeconds();
+	ResolveComponents(Agent);
+	Pawn->OnTakeAnyDamage.AddUniqueDynamic(this, &UPhantoAILODSubsystem::HandleTakeAnyDamage);
+}
+
+void UPhantoAILODSubsystem::UnregisterAgent(APawn* Pawn)
+{
+	auto const Index = Agents.IndexOfByPredicate([Pawn](const FAgent& Agent) { return Agent.Pawn == Pawn; });
+	if (Index == INDEX_NONE)
+		return;
+
+	ResolveComponents(Agents[Index]);
+	ApplyTier(Agents[Index], EPhantoAILODTier::High);
+	Pawn->OnTakeAnyDamage.RemoveDynamic(this, &UPhantoAILODSubsystem::HandleTakeAnyDamage);
+	Agents.RemoveAtSwap(Index, EAllowShrinking::No);
+}
+
+void UPhantoAILODSubsystem::NotifyInteraction(APawn* Pawn)
+{
+	auto Agent = Agents.FindByPredicate([Pawn](const FAgent& Agent) { return Agent.Pawn == Pawn; });
+	if (!Agent)
+		return;
+
+	auto const Time = GetWorld()->GetTimeSeconds();
+	Agent->InteractionTime = Time;
+	if (!bEnabled || Agent->Tier == EPhantoAILODTier::High)
+		return;
+
+	// Right away rather than at the next classification, the pawn is about to react.
+	++Stats.Promotions;
+	Agent->Tier = EPhantoAILODTier::High;
+	Agent->TierTime = Time;
+	ApplyTier(*Agent, Agent->Tier);
+}
+
+EPhantoAILODTier UPhantoAILODSubsystem::GetTier(const APawn* Pawn) const
+{
+	auto Agent = Agents.FindByPredicate([Pawn](const FAgent& Agent) { return Agent.Pawn == Pawn; });
+	return Agent ? Agent->Tier : EPhantoAILODTier::High;
+}
+
+void UPhantoAILODSubsystem::SetViewOverride(const FVector& Location, const FVector& Direction)
+{
+	ViewOverrideLocation = Location;
+	ViewOverrideDirection = Direction;
+	bHasViewOverride = true;
+}
+
+void UPhantoAILODSubsystem::ResetStats()
+{
+	Stats.Promotions = 0;
+	Stats.Demotions = 0;
+}
+
+void UPhantoAILODSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	auto const Time = GetWorld()->GetTimeSeconds();
+	if (Time >= NextUpdateTime)
+	{
+		NextUpdateTime = Time + UpdateInterval;
+		Classify(Time);
+	}
+	ThrottleBehaviorTrees();
+
+	// Counter stats are cleared every frame, the counts of the last classification are set again.
+	SET_DWORD_STAT(STAT_PhantoAILODHigh, Stats.NumHigh);
+	SET_DWORD_STAT(STAT_PhantoAILODMedium, Stats.NumMedium);
+	SET_DWORD_STAT(STAT_PhantoAILODLow, Stats.NumLow);
+}
+
+TStatId UPhantoAILODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPhantoAILODSubsystem, STATGROUP_Tickables);
+}
+
+bool UPhantoAILODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPhantoAILODSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (TActorIterator<APawn> It(&InWorld); It; ++It)
+	{
+		HandleActorSpawned(*It);
+	}
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UPhantoAILODSubsystem::HandleActorSpawned));
+}
+
+void UPhantoAILODSubsystem::Deinitialize()
+{
+	GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	Agents.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UPhantoAILODSubsystem::GetView(FVector& OutLocation, FVector& OutDirection) const
+{
+	if (bHasViewOverride)
+	{
+		OutLocation = ViewOverrideLocation;
+		OutDirection = ViewOverrideDirection;
+		return true;
+	}
+
+	auto CameraManager = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0);
+	if (!CameraManager)
+		return false;
+
+	OutLocation = CameraManager->GetCameraLocation();
+	OutDirection = CameraManager->GetCameraRotation().Vector();
+	return true;
+}
+
+void UPhantoAILODSubsystem::Classify(double Time)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoAILODClassify);
+
+	Agents.RemoveAllSwap([](const FAgent& Agent) { return !Agent.Pawn.IsValid(); }, EAllowShrinking::No);
+
+	FVector ViewLocation, ViewDirection;
+	auto const bHasView = bEnabled && GetView(ViewLocation, ViewDirection);
+
+	Locations.Reset(Agents.Num());
+	for (auto const& Agent : Agents)
+	{
+		Locations.Add(Agent.Pawn->GetActorLocation());
+	}
+
+	// 2 inside the view cone, 1 only inside its margin.
+	ViewStates.Reset(Agents.Num());
+	ViewStates.AddZeroed(Agents.Num());
+	if (bHasView)
+	{
+		ConeIndices.Reset();
+		PhantoVectorMath::FindInCone(ViewLocation, ViewDirection, FMath::DegreesToRadians(FMath::Min(ViewHalfAngle + AngleMargin, 180.f)), 0, Locations, ConeIndices);
+		for (auto Index : ConeIndices)
+		{
+			ViewStates[Index] = 1;
+		}
+
+		ConeIndices.Reset();
+		PhantoVectorMath::FindInCone(ViewLocation, ViewDirection, FMath::DegreesToRadians(ViewHalfAngle), 0, Locations, ConeIndices);
+		for (auto Index : ConeIndices)
+		{
+			ViewStates[Index] = 2;
+		}
+	}
+
+	int32 Counts[3] = {};
+	for (auto i = 0; i < Agents.Num(); ++i)
+	{
+		auto& Agent = Agents[i];
+		auto const bComponentsChanged = ResolveComponents(Agent);
+
+		// Pooled pawns are hidden and don't tick, there's nothing to throttle.
+		if (Agent.Pawn->IsHidden())
+			continue;
+
+		auto Tier = EPhantoAILODTier::High;
+		if (bHasView)
+		{
+			Agent.bInView = ViewStates[i] == 2 || (Agent.bInView && ViewStates[i] == 1);
+			Tier = GetDesiredTier(Agent, FVector::DistSquared(ViewLocation, Locations[i]), Time);
+
+			// Promoted right away, demoted only after MinTierTime.
+			if (Tier > Agent.Tier && Time - Agent.TierTime < MinTierTime)
+				Tier = Agent.Tier;
+		}
+
+		if (Tier != Agent.Tier)
+		{
+			if (Tier < Agent.Tier)
+				++Stats.Promotions;
+			else
+				++Stats.Demotions;
+			Agent.Tier = Tier;
+			Agent.TierTime = Time;
+			ApplyTier(Agent, Tier);
+		}
+		else if (bComponentsChanged)
+		{
+			ApplyTier(Agent, Tier);
+		}
+		++Counts[int32(Tier)];
+	}
+
+	Stats.NumHigh = Counts[int32(EPhantoAILODTier::High)];
+	Stats.NumMedium = Counts[int32(EPhantoAILODTier::Medium)];
+	Stats.NumLow = Counts[int32(EPhantoAILODTier::Low)];
+}
+
+EPhantoAILODTier UPhantoAILODSubsystem::GetDesiredTier(const FAgent& Agent, double DistanceSquared, double Time) const
+{
+	if (Time - Agent.InteractionTime < InteractionTime)
+		return EPhantoAILODTier::High;
+
+	// A pawn already in the tier a distance grants keeps it up to the margin further.
+	auto IsWithin = [&](float Distance, EPhantoAILODTier Granted)
+	{
+		auto const Margin = Agent.Tier <= Granted ? DistanceMargin : 0;
+		return DistanceSquared < FMath::Square(Distance + Margin);
+	};
+
+	if (Agent.bInView)
+		return IsWithin(HighDistance, EPhantoAILODTier::High) ? EPhantoAILODTier::High : EPhantoAILODTier::Medium;
+
+	return IsWithin(MediumDistance, EPhantoAILODTier::Medium) ? EPhantoAILODTier::Medium : EPhantoAILODTier::Low;
+}
+
+const FPhantoAILODTierSettings& UPhantoAILODSubsystem::GetSettings(EPhantoAILODTier Tier) const
+{
+	static const FPhantoAILODTierSettings FullRate;
+	return TierSettings.IsValidIndex(int32(Tier)) ? TierSettings[int32(Tier)] : FullRate;
+}
+
+bool UPhantoAILODSubsystem::ResolveComponents(FAgent& Agent)
+{
+	// The controller and its tree can come after the pawn, and change.
+	auto Controller = Cast<AAIController>(Agent.Pawn->GetController());
+	auto BehaviorTree = Controller ? Cast<UBehaviorTreeComponent>(Controller->GetBrainComponent()) : nullptr;
+	auto PathFollowing = Controller ? Controller->GetPathFollowingComponent() : nullptr;
+	if (Agent.BehaviorTree.Get() == BehaviorTree && Agent.PathFollowing.Get() == PathFollowing)
+		return false;
+
+	Agent.BehaviorTree = BehaviorTree;
+	Agent.PathFollowing = PathFollowing;
+	return true;
+}
+
+void UPhantoAILODSubsystem::ApplyTier(const FAgent& Agent, EPhantoAILODTier Tier) const
+{
+	auto const& Settings = GetSettings(Tier);
+
+	if (auto PathFollowing = Agent.PathFollowing.Get())
+		PathFollowing->SetComponentTickInterval(Settings.PathFollowingInterval);
+
+	if (auto Pawn = Agent.Pawn.Get())
+	{
+		Pawn->ForEachComponent<USkeletalMeshComponent>(false, [&Settings](USkeletalMeshComponent* Mesh)
+		{
+			Mesh->SetComponentTickInterval(Settings.AnimationInterval);
+		});
+	}
+
+	// A tree waiting out a longer interval of a lower tier shouldn't keep waiting once promoted.
+	auto BehaviorTree = Agent.BehaviorTree.Get();
+	if (BehaviorTree && BehaviorTree->IsComponentTickEnabled() && BehaviorTree->GetComponentTickInterval() > Settings.BehaviorTreeInterval)
+		BehaviorTree->SetComponentTickIntervalAndCooldown(Settings.BehaviorTreeInterval);
+}
+
+void UPhantoAILODSubsystem::ThrottleBehaviorTrees()
+{
+	if (!bEnabled)
+		return;
+
+	for (auto const& Agent : Agents)
+	{
+		auto const Interval = GetSettings(Agent.Tier).BehaviorTreeInterval;
+		auto BehaviorTree = Interval > 0 ? Agent.BehaviorTree.Get() : nullptr;
+
+		// The tree sets its own interval to what its tasks and services need every time it ticks, and to 0 when a task
+		// finishes or a key it observes changes; both are raised back, there's no telling them apart from here.
+		if (BehaviorTree && BehaviorTree->IsComponentTickEnabled() && BehaviorTree->GetComponentTickInterval() < Interval)
+			BehaviorTree->SetComponentTickIntervalAndCooldown(Interval);
+	}
+}
+
+void UPhantoAILODSubsystem::HandleActorSpawned(AActor* Actor)
+{
+	auto Pawn = Cast<APawn>(Actor);
+	if (Pawn && Cast<AAIController>(Pawn->GetController()))
+		RegisterAgent(Pawn);
+}
+
+void UPhantoAILODSubsystem::HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+{
+	NotifyInteraction(Cast<APawn>(DamagedActor));
+}
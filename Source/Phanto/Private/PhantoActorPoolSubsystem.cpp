@@ -0,0 +1,225 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoActorPoolSubsystem.h"
+
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "Phanto.h"
+#include "PhantoPoolable.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Hits"), STAT_PhantoPoolHits, STATGROUP_Phanto);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Misses"), STAT_PhantoPoolMisses, STATGROUP_Phanto);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actors"), STAT_PhantoPooledActors, STATGROUP_Phanto);
+
+void UPhantoActorPoolSubsystem::Prewarm(TSubclassOf<AActor> Class, int32 Count)
+{
+	if (!Class)
+		return;
+
+	auto& Pool = Pools.FindOrAdd(Class);
+	Count = FMath::Min(Count, MaxPooledPerClass);
+	while (Pool.Free.Num() < Count)
+	{
+		auto Actor = Spawn(Class, FTransform::Identity, nullptr, nullptr);
+		if (!Actor)
+			break;
+
+		Deactivate(Actor);
+		Pool.Free.Add(Actor);
+		++Pool.Stats.Prewarmed;
+		INC_DWORD_STAT(STAT_PhantoPooledActors);
+	}
+
+	Pool.Stats.Pooled = Pool.Free.Num();
+}
+
+AActor* UPhantoActorPoolSubsystem::Acquire(TSubclassOf<AActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	if (!Class)
+		return nullptr;
+
+	auto& Pool = Pools.FindOrAdd(Class);
+	AActor* Actor = nullptr;
+	while (!Actor && !Pool.Free.IsEmpty())
+	{
+		Actor = Pool.Free.Pop(EAllowShrinking::No);
+		DEC_DWORD_STAT(STAT_PhantoPooledActors);
+
+		// Destroyed while pooled, e.g. by a level unload.
+		if (!IsValid(Actor))
+			Actor = nullptr;
+	}
+
+	if (Actor)
+	{
+		++Pool.Stats.Hits;
+		INC_DWORD_STAT(STAT_PhantoPoolHits);
+		Actor->SetOwner(Owner);
+		Actor->SetInstigator(Instigator);
+		Activate(Actor, Transform);
+	}
+	else
+	{
+		++Pool.Stats.Misses;
+		INC_DWORD_STAT(STAT_PhantoPoolMisses);
+		Actor = Spawn(Class, Transform, Owner, Instigator);
+		if (!Actor)
+			return nullptr;
+	}
+
+	++Pool.Stats.InUse;
+	Pool.Stats.HighWaterMark = FMath::Max(Pool.Stats.HighWaterMark, Pool.Stats.InUse);
+	Pool.Stats.Pooled = Pool.Free.Num();
+	return Actor;
+}
+
+void UPhantoActorPoolSubsystem::Release(AActor* Actor)
+{
+	if (!IsValid(Actor))
+		return;
+
+	auto& Pool = Pools.FindOrAdd(Actor->GetClass());
+	if (Pool.Free.Contains(Actor))
+		return;
+
+	Pool.Stats.InUse = FMath::Max(Pool.Stats.InUse - 1, 0);
+
+	auto const Limit = FMath::Min(FMath::Max(Pool.Stats.HighWaterMark, Pool.Stats.Prewarmed), MaxPooledPerClass);
+	if (Pool.Free.Num() >= Limit)
+	{
+		++Pool.Stats.Discarded;
+		Actor->Destroy();
+		return;
+	}
+
+	Deactivate(Actor);
+	Pool.Free.Add(Actor);
+	++Pool.Stats.DestroysAvoided;
+	Pool.Stats.Pooled = Pool.Free.Num();
+	INC_DWORD_STAT(STAT_PhantoPooledActors);
+}
+
+void UPhantoActorPoolSubsystem::EmptyPools()
+{
+	for (auto& [Class, Pool] : Pools)
+	{
+		for (auto Actor : Pool.Free)
+		{
+			if (IsValid(Actor))
+				Actor->Destroy();
+		}
+		Pool.Free.Reset();
+		Pool.Stats.Pooled = 0;
+	}
+
+	SET_DWORD_STAT(STAT_PhantoPooledActors, 0);
+}
+
+FPhantoActorPoolStats UPhantoActorPoolSubsystem::GetPoolStats(TSubclassOf<AActor> Class) const
+{
+	auto Pool = Pools.Find(Class);
+	return Pool ? Pool->Stats : FPhantoActorPoolStats();
+}
+
+FPhantoActorPoolStats UPhantoActorPoolSubsystem::GetTotalStats() const
+{
+	FPhantoActorPoolStats Total;
+	for (auto const& [Class, Pool] : Pools)
+	{
+		Total.Hits += Pool.Stats.Hits;
+		Total.Misses += Pool.Stats.Misses;
+		Total.DestroysAvoided += Pool.Stats.DestroysAvoided;
+		Total.Discarded += Pool.Stats.Discarded;
+		Total.Prewarmed += Pool.Stats.Prewarmed;
+		Total.InUse += Pool.Stats.InUse;
+		Total.HighWaterMark += Pool.Stats.HighWaterMark;
+		Total.Pooled += Pool.Stats.Pooled;
+	}
+	return Total;
+}
+
+bool UPhantoActorPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPhantoActorPoolSubsystem::Deinitialize()
+{
+	Pools.Reset();
+	Super::Deinitialize();
+}
+
+AActor* UPhantoActorPoolSubsystem::Spawn(TSubclassOf<AActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator) const
+{
+	FActorSpawnParameters Params;
+	Params.Owner = Owner;
+	Params.Instigator = Instigator;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AActor>(Class, Transform, Params);
+}
+
+void UPhantoActorPoolSubsystem::Deactivate(AActor* Actor) const
+{
+	if (Actor->Implements<UPhantoPoolable>())
+		IPhantoPoolable::Execute_OnReleasedToPool(Actor);
+
+	if (auto Pawn = Cast<APawn>(Actor))
+	{
+		if (auto Controller = Cast<AAIController>(Pawn->GetController()))
+		{
+			Controller->StopMovement();
+			if (Controller->BrainComponent)
+				Controller->BrainComponent->StopLogic(TEXT("Pooled"));
+		}
+
+		if (auto Movement = Pawn->GetMovementComponent())
+			Movement->StopMovementImmediately();
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+	for (auto Component : Actor->GetComponents())
+	{
+		Component->Deactivate();
+		Component->SetComponentTickEnabled(false);
+	}
+}
+
+void UPhantoActorPoolSubsystem::Activate(AActor* Actor, const FTransform& Transform) const
+{
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+
+	for (auto Component : Actor->GetComponents())
+	{
+		if (Component->bAutoActivate)
+			Component->Activate(true);
+	}
+
+	// After activating, which turns ticks on: back to the state the components were spawned in. Components enabling
+	// their tick at runtime do it again from OnAcquiredFromPool.
+	for (auto Component : Actor->GetComponents())
+	{
+		if (Component->PrimaryComponentTick.bCanEverTick)
+			Component->SetComponentTickEnabled(Component->PrimaryComponentTick.bStartWithTickEnabled);
+	}
+
+	if (auto Pawn = Cast<APawn>(Actor))
+	{
+		if (auto Controller = Cast<AAIController>(Pawn->GetController()))
+		{
+			if (Controller->BrainComponent)
+				Controller->BrainComponent->RestartLogic();
+		}
+	}
+
+	if (Actor->Implements<UPhantoPoolable>())
+		IPhantoPoolable::Execute_OnAcquiredFromPool(Actor);
+}
@@ -0,0 +1,202 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoAnimStateBridgeComponent.h"
+
+#include "AIController.h"
+#include "Animation/AnimInstance.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PawnMovementComponent.h"
+
+UPhantoAnimStateBridgeComponent::UPhantoAnimStateBridgeComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+FNumericProperty* UPhantoAnimStateBridgeComponent::FindAnimStateProperty(const UObject& Object, FName Name)
+{
+	auto Property = FindFProperty<FProperty>(Object.GetClass(), Name);
+	if (auto EnumProperty = CastField<FEnumProperty>(Property))
+		return EnumProperty->GetUnderlyingProperty();
+
+	auto NumericProperty = CastField<FNumericProperty>(Property);
+	return NumericProperty && NumericProperty->IsInteger() ? NumericProperty : nullptr;
+}
+
+APawn* UPhantoAnimStateBridgeComponent::GetPawn() const
+{
+	return Cast<APawn>(GetOwner());
+}
+
+void UPhantoAnimStateBridgeComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	auto Pawn = GetPawn();
+	if (!Pawn)
+		return;
+
+	Pawn->ReceiveControllerChangedDelegate.AddDynamic(this, &UPhantoAnimStateBridgeComponent::HandleControllerChanged);
+	if (auto Controller = Cast<AAIController>(Pawn->GetController()))
+		SetBlackboard(Controller->GetBlackboardComponent());
+
+	if (auto Character = Cast<ACharacter>(Pawn))
+	{
+		Character->MovementModeChangedDelegate.AddDynamic(this, &UPhantoAnimStateBridgeComponent::HandleMovementModeChanged);
+		Character->OnCharacterMovementUpdated.AddDynamic(this, &UPhantoAnimStateBridgeComponent::HandleMovementUpdated);
+	}
+	else if (MovingState != IdleState)
+	{
+		SetComponentTickInterval(MovementPollInterval);
+		SetComponentTickEnabled(true);
+	}
+
+	bWasMoving = IsMoving();
+	RefreshState();
+}
+
+void UPhantoAnimStateBridgeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetBlackboard(nullptr);
+
+	if (auto Pawn = GetPawn())
+		Pawn->ReceiveControllerChangedDelegate.RemoveAll(this);
+
+	if (auto Character = Cast<ACharacter>(GetOwner()))
+	{
+		Character->MovementModeChangedDelegate.RemoveAll(this);
+		Character->OnCharacterMovementUpdated.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UPhantoAnimStateBridgeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	auto const bMoving = IsMoving();
+	if (bMoving != bWasMoving)
+	{
+		bWasMoving = bMoving;
+		RefreshState();
+	}
+}
+
+void UPhantoAnimStateBridgeComponent::SetBlackboard(UBlackboardComponent* Blackboard)
+{
+	if (ObservedBlackboard == Blackboard)
+		return;
+
+	if (auto Previous = ObservedBlackboard.Get())
+		Previous->UnregisterObserversFrom(this);
+
+	ObservedBlackboard = Blackboard;
+	KeyIds.Reset();
+	if (!Blackboard)
+		return;
+
+	for (auto const& KeyState : KeyStates)
+	{
+		auto const KeyId = Blackboard->GetKeyID(KeyState.Key);
+		KeyIds.Add(KeyId);
+		if (KeyId != FBlackboard::InvalidKey)
+			Blackboard->RegisterObserver(KeyId, this, FOnBlackboardChangeNotification::CreateUObject(this, &UPhantoAnimStateBridgeComponent::HandleKeyChanged));
+	}
+	RefreshState();
+}
+
+bool UPhantoAnimStateBridgeComponent::IsMoving() const
+{
+	auto Pawn = GetPawn();
+	return Pawn && Pawn->GetVelocity().SizeSquared() > FMath::Square(MovingSpeed);
+}
+
+uint8 UPhantoAnimStateBridgeComponent::DeriveState() const
+{
+	if (auto Blackboard = ObservedBlackboard.Get())
+	{
+		for (auto i = 0; i < KeyIds.Num(); ++i)
+		{
+			if (KeyIds[i] != FBlackboard::InvalidKey && Blackboard->GetValue<UBlackboardKeyType_Bool>(KeyIds[i]))
+				return KeyStates[i].State;
+		}
+	}
+
+	auto Pawn = GetPawn();
+	auto Movement = Pawn ? Pawn->GetMovementComponent() : nullptr;
+	if (Movement && Movement->IsFalling())
+		return FallingState;
+
+	return bWasMoving ? MovingState : IdleState;
+}
+
+bool UPhantoAnimStateBridgeComponent::ResolveStateProperty()
+{
+	if (StateTarget.IsValid() && StateProperty)
+		return true;
+
+	StateTarget = nullptr;
+	StateProperty = nullptr;
+
+	// The anim instance is only created once the mesh is initialized, so this is retried until it's found.
+	auto Pawn = GetPawn();
+	auto Mesh = Pawn ? Pawn->FindComponentByClass<USkeletalMeshComponent>() : nullptr;
+	auto AnimInstance = Mesh ? Mesh->GetAnimInstance() : nullptr;
+	for (UObject* Candidate : { static_cast<UObject*>(AnimInstance), static_cast<UObject*>(Pawn) })
+	{
+		if (auto Property = Candidate ? FindAnimStateProperty(*Candidate, AnimStateProperty) : nullptr)
+		{
+			StateTarget = Candidate;
+			StateProperty = Property;
+			return true;
+		}
+	}
+	return false;
+}
+
+void UPhantoAnimStateBridgeComponent::RefreshState()
+{
+	auto const State = DeriveState();
+	if (bHasWrittenState && State == CurrentState)
+		return;
+
+	if (!ResolveStateProperty())
+		return;
+
+	CurrentState = State;
+	bHasWrittenState = true;
+	++NumWrites;
+	StateProperty->SetIntPropertyValue(StateProperty->ContainerPtrToValuePtr<void>(StateTarget.Get()), int64(State));
+}
+
+EBlackboardNotificationResult UPhantoAnimStateBridgeComponent::HandleKeyChanged(const UBlackboardComponent& Blackboard, FBlackboard::FKey Key)
+{
+	RefreshState();
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+void UPhantoAnimStateBridgeComponent::HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	auto Controller = Cast<AAIController>(NewController);
+	SetBlackboard(Controller ? Controller->GetBlackboardComponent() : nullptr);
+}
+
+void UPhantoAnimStateBridgeComponent::HandleMovementModeChanged(ACharacter* Character, EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	RefreshState();
+}
+
+void UPhantoAnimStateBridgeComponent::HandleMovementUpdated(float DeltaSeconds, FVector OldLocation, FVector OldVelocity)
+{
+	// Called on every movement update, only crossing the moving speed is a change.
+	auto const bMoving = IsMoving();
+	if (bMoving != bWasMoving)
+	{
+		bWasMoving = bMoving;
+		RefreshState();
+	}
+}
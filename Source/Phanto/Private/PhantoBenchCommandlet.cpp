@@ -0,0 +1,358 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoBenchCommandlet.h"
+
+#include "AIController.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/PlatformMemory.h"
+#include "JsonObjectConverter.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NavigationSystem.h"
+#include "Phanto.h"
+#include "PhantoActorPoolSubsystem.h"
+#include "PhantoAILODSubsystem.h"
+#include "PhantoNavBuildSchedulerSubsystem.h"
+#include "PhantoNavLinkGeneratorComponent.h"
+#include "PhantoPathRequestSubsystem.h"
+#include "PhantoReplaySceneActor.h"
+#include "PhantoSceneAnchorRegistry.h"
+#include "PhantoSceneBVHSubsystem.h"
+#include "PhantoSurfaceSampleSubsystem.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Package.h"
+
+namespace
+{
+	constexpr double BytesToMB = 1.0 / (1024 * 1024);
+
+	void DestroyBenchWorld(UWorld& World)
+	{
+		World.DestroyWorld(false);
+		GEngine->DestroyWorldContext(&World);
+		World.RemoveFromRoot();
+		GWorld = nullptr;
+	}
+
+	template <typename StructType>
+	TSharedPtr<FJsonObject> StatsToJson(const StructType& Stats)
+	{
+		return FJsonObjectConverter::UStructToJsonObject(Stats);
+	}
+
+	void AddFrameTimes(FJsonObject& Phase, TArray<double> FrameMs)
+	{
+		if (FrameMs.Num() == 0)
+			return;
+
+		FrameMs.Sort();
+		auto Total = 0.0;
+		for (auto Ms : FrameMs)
+		{
+			Total += Ms;
+		}
+
+		auto Percentile = [&FrameMs](double Fraction) { return FrameMs[FMath::Min(FrameMs.Num() - 1, int32(FrameMs.Num() * Fraction))]; };
+		auto Times = MakeShared<FJsonObject>();
+		Times->SetNumberField(TEXT("Average"), Total / FrameMs.Num());
+		Times->SetNumberField(TEXT("P50"), Percentile(0.5));
+		Times->SetNumberField(TEXT("P95"), Percentile(0.95));
+		Times->SetNumberField(TEXT("P99"), Percentile(0.99));
+		Times->SetNumberField(TEXT("Max"), FrameMs.Last());
+		Phase.SetObjectField(TEXT("FrameMs"), Times);
+	}
+}
+
+UPhantoBenchCommandlet::UPhantoBenchCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+double UPhantoBenchCommandlet::TickWorld(UWorld& World)
+{
+	auto const StartTime = FPlatformTime::Seconds();
+
+	FApp::SetDeltaTime(DeltaSeconds);
+	FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaSeconds);
+	World.Tick(LEVELTICK_All, DeltaSeconds);
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	FTSTicker::GetCoreTicker().Tick(DeltaSeconds);
+	++GFrameCounter;
+
+	PeakUsedPhysical = FMath::Max(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+	return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+int32 UPhantoBenchCommandlet::TickWhile(UWorld& World, int32 MaxFrames, TFunctionRef<bool()> Predicate)
+{
+	auto Frames = 0;
+	while (Frames < MaxFrames && Predicate())
+	{
+		TickWorld(World);
+		++Frames;
+	}
+	return Frames;
+}
+
+TSharedRef<FJsonObject> UPhantoBenchCommandlet::AddPhase(FJsonObject& Report, const FString& Name, double StartTime)
+{
+	auto const Milliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	PeakUsedPhysical = FMath::Max(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+
+	auto Phase = MakeShared<FJsonObject>();
+	Phase->SetNumberField(TEXT("Ms"), Milliseconds);
+	Phase->SetNumberField(TEXT("PeakUsedPhysicalMB"), PeakUsedPhysical * BytesToMB);
+	Report.SetObjectField(Name, Phase);
+
+	UE_LOG(LogPhanto, Display, TEXT("PhantoBench: %s took %.2f ms"), *Name, Milliseconds);
+	return Phase;
+}
+
+double UPhantoBenchCommandlet::RunWave(UWorld& World, FJsonObject& Phases, const FString& Name, TSubclassOf<APawn> PhantomClass,
+	int32 NumPhantoms, UBehaviorTree* BehaviorTree, float Seconds, double BaselineMs)
+{
+	auto const StartTime = FPlatformTime::Seconds();
+	auto ActorPool = World.GetSubsystem<UPhantoActorPoolSubsystem>();
+	auto SurfaceSamples = World.GetSubsystem<UPhantoSurfaceSampleSubsystem>();
+	auto AILOD = World.GetSubsystem<UPhantoAILODSubsystem>();
+
+	TArray<APawn*> Pawns;
+	for (auto i = 0; PhantomClass && i < NumPhantoms; ++i)
+	{
+		FVector Location, Normal;
+		if (!SurfaceSamples->GetRandomSurfacePoint(EPhantoSemanticLabel::Floor, Location, Normal))
+			break;
+
+		auto const Rotation = FRotator(0, FMath::FRandRange(-180.0, 180.0), 0);
+		auto Pawn = Cast<APawn>(ActorPool->Acquire(PhantomClass, FTransform(Rotation, Location + Normal * 50), nullptr, nullptr));
+		if (!Pawn)
+			continue;
+
+		if (!Pawn->GetController())
+			Pawn->SpawnDefaultController();
+		if (auto Controller = Cast<AAIController>(Pawn->GetController()); Controller && BehaviorTree)
+			Controller->RunBehaviorTree(BehaviorTree);
+		AILOD->RegisterAgent(Pawn);
+		Pawns.Add(Pawn);
+	}
+
+	TArray<double> FrameMs;
+	auto const NumFrames = FMath::CeilToInt(Seconds / DeltaSeconds);
+	FrameMs.Reserve(NumFrames);
+	auto TotalMs = 0.0;
+	for (auto Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		TotalMs += FrameMs.Add_GetRef(TickWorld(World));
+	}
+	auto const AverageMs = NumFrames > 0 ? TotalMs / NumFrames : 0.0;
+	auto const LODStats = AILOD->GetStats();
+
+	// Back to the pool, the next wave reuses them.
+	for (auto Pawn : Pawns)
+	{
+		ActorPool->Release(Pawn);
+	}
+
+	auto Phase = AddPhase(Phases, Name, StartTime);
+	Phase->SetNumberField(TEXT("Phantoms"), Pawns.Num());
+	Phase->SetNumberField(TEXT("Frames"), NumFrames);
+	if (Pawns.Num() > 0)
+		Phase->SetNumberField(TEXT("MsPerPhantom"), (AverageMs - BaselineMs) / Pawns.Num());
+	if (Pawns.Num() > 0 && AILOD->bEnabled)
+		Phase->SetObjectField(TEXT("AILOD"), StatsToJson(LODStats));
+	AddFrameTimes(*Phase, MoveTemp(FrameMs));
+	return AverageMs;
+}
+
+int32 UPhantoBenchCommandlet::Main(const FString& Params)
+{
+	FString MapName = TEXT("/Game/Phanto/Maps/GameScene");
+	FString RoomPath;
+	FString PhantomClassPath = TEXT("/Game/Phanto/Enemies/Phantom/BP_Phantom.BP_Phantom_C");
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Bench"), FString::Printf(TEXT("PhantoBench_%s.json"), *FDateTime::Now().ToString()));
+	auto Seconds = 30.f;
+	auto Fps = 72.f;
+	FString Phantoms = TEXT("8,32,128");
+	FString BehaviorTreePath;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Room="), RoomPath);
+	FParse::Value(*Params, TEXT("PhantomClass="), PhantomClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FParse::Value(*Params, TEXT("Fps="), Fps);
+	FParse::Value(*Params, TEXT("Phantoms="), Phantoms);
+	FParse::Value(*Params, TEXT("BehaviorTree="), BehaviorTreePath);
+	auto const bAILOD = FParse::Param(*Params, TEXT("AILOD"));
+
+	TArray<FString> PhantomCounts;
+	Phantoms.ParseIntoArray(PhantomCounts, TEXT(","));
+
+	if (RoomPath.IsEmpty())
+	{
+		UE_LOG(LogPhanto, Error, TEXT("PhantoBench: -Room=<capture.phsc> is required, see Phanto.CaptureScene"));
+		return 1;
+	}
+
+	DeltaSeconds = 1.f / FMath::Max(Fps, 1.f);
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(DeltaSeconds);
+
+	auto Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Map"), MapName);
+	Report->SetStringField(TEXT("Room"), RoomPath);
+	Report->SetNumberField(TEXT("FixedDeltaSeconds"), DeltaSeconds);
+	Report->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	auto Phases = MakeShared<FJsonObject>();
+
+	// Load the map as a game world, without a game instance: the map's game mode needs a player and a headset.
+	auto StartTime = FPlatformTime::Seconds();
+	auto Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	auto World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogPhanto, Error, TEXT("PhantoBench: couldn't load map %s"), *MapName);
+		return 1;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+	auto& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	GWorld = World;
+
+	World->InitWorld(UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.CreatePhysicsScene(true)
+		.CreateNavigation(true)
+		.CreateAISystem(true)
+		.ShouldSimulatePhysics(true));
+	World->UpdateWorldComponents(true, true);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+	if (!World->GetAuthGameMode())
+		World->GetWorldSettings()->NotifyBeginPlay();
+	AddPhase(*Phases, TEXT("LoadMap"), StartTime);
+
+	// Scene population, the same steps as on device.
+	StartTime = FPlatformTime::Seconds();
+	auto ReplayActor = World->SpawnActor<APhantoReplaySceneActor>();
+	if (!ReplayActor || !ReplayActor->LoadCapture(RoomPath))
+	{
+		UE_LOG(LogPhanto, Error, TEXT("PhantoBench: couldn't replay room %s"), *RoomPath);
+		DestroyBenchWorld(*World);
+		return 1;
+	}
+	AddPhase(*Phases, TEXT("Populate"), StartTime)->SetNumberField(TEXT("Anchors"), ReplayActor->GetAnchorActors().Num());
+
+	StartTime = FPlatformTime::Seconds();
+	World->GetSubsystem<UPhantoSceneAnchorRegistry>()->RefreshAnchors();
+	AddPhase(*Phases, TEXT("AnchorRegistry"), StartTime);
+
+	StartTime = FPlatformTime::Seconds();
+	World->GetSubsystem<UPhantoSceneBVHSubsystem>()->BuildFromActors({ ReplayActor });
+	AddPhase(*Phases, TEXT("SceneBVH"), StartTime);
+
+	StartTime = FPlatformTime::Seconds();
+	auto SurfaceSamples = World->GetSubsystem<UPhantoSurfaceSampleSubsystem>();
+	auto const NumPoints = SurfaceSamples->BuildFromActors({ ReplayActor });
+	AddPhase(*Phases, TEXT("SurfaceSamples"), StartTime)->SetNumberField(TEXT("Points"), NumPoints);
+
+	// Full nav build over the room, ticked until the generator is done.
+	constexpr int32 MaxWaitFrames = 72 * 120;
+	StartTime = FPlatformTime::Seconds();
+	auto NavSystem = UNavigationSystemV1::GetNavigationSystem(World);
+	auto NavData = NavSystem ? NavSystem->GetDefaultNavDataInstance() : nullptr;
+	if (NavData)
+		NavData->RebuildAll();
+	auto const NavFrames = TickWhile(*World, MaxWaitFrames, [NavSystem] { return NavSystem && NavSystem->IsNavigationBuildInProgress(); });
+	auto NavBuild = AddPhase(*Phases, TEXT("NavBuild"), StartTime);
+	NavBuild->SetNumberField(TEXT("Frames"), NavFrames);
+	NavBuild->SetBoolField(TEXT("HasNavData"), NavData != nullptr);
+
+	StartTime = FPlatformTime::Seconds();
+	UPhantoNavLinkGeneratorComponent* LinkGenerator = nullptr;
+	for (TActorIterator<AActor> It(World); It && !LinkGenerator; ++It)
+	{
+		LinkGenerator = It->FindComponentByClass<UPhantoNavLinkGeneratorComponent>();
+	}
+	if (!LinkGenerator)
+	{
+		LinkGenerator = NewObject<UPhantoNavLinkGeneratorComponent>(ReplayActor);
+		LinkGenerator->RegisterComponent();
+	}
+	LinkGenerator->GenerateLinks();
+	auto const LinkFrames = TickWhile(*World, MaxWaitFrames, [LinkGenerator] { return LinkGenerator->IsGenerating(); });
+	TickWhile(*World, MaxWaitFrames, [NavSystem] { return NavSystem && NavSystem->IsNavigationBuildInProgress(); });
+	auto NavLinks = AddPhase(*Phases, TEXT("NavLinks"), StartTime);
+	NavLinks->SetNumberField(TEXT("Frames"), LinkFrames);
+	NavLinks->SetNumberField(TEXT("Links"), LinkGenerator->GetLinks().Num());
+
+	// Scripted waves: the Phantoms spawn on the floor and run their behavior for the requested time, after a run
+	// without them to tell their cost from the rest of the frame.
+	auto PhantomClass = LoadClass<APawn>(nullptr, *PhantomClassPath);
+	if (!PhantomClass)
+		UE_LOG(LogPhanto, Warning, TEXT("PhantoBench: couldn't load Phantom class %s"), *PhantomClassPath);
+
+	auto BehaviorTree = BehaviorTreePath.IsEmpty() ? nullptr : LoadObject<UBehaviorTree>(nullptr, *BehaviorTreePath);
+	if (!BehaviorTreePath.IsEmpty() && !BehaviorTree)
+		UE_LOG(LogPhanto, Warning, TEXT("PhantoBench: couldn't load behavior tree %s"), *BehaviorTreePath);
+
+	// There's no player, AI LOD views the room from a random spot on the floor at head height when asked for.
+	auto AILOD = World->GetSubsystem<UPhantoAILODSubsystem>();
+	AILOD->bEnabled = bAILOD;
+	FVector ViewLocation, ViewNormal;
+	if (bAILOD && SurfaceSamples->GetRandomSurfacePoint(EPhantoSemanticLabel::Floor, ViewLocation, ViewNormal))
+		AILOD->SetViewOverride(ViewLocation + ViewNormal * 160, FRotator(0, FMath::FRandRange(-180.0, 180.0), 0).Vector());
+	Report->SetBoolField(TEXT("AILOD"), bAILOD);
+
+	auto const BaselineMs = RunWave(*World, *Phases, TEXT("Baseline"), nullptr, 0, nullptr, Seconds);
+	for (auto const& Count : PhantomCounts)
+	{
+		auto const NumPhantoms = FCString::Atoi(*Count);
+		auto const Name = PhantomCounts.Num() > 1 ? FString::Printf(TEXT("Wave_%d"), NumPhantoms) : FString(TEXT("Wave"));
+		RunWave(*World, *Phases, Name, PhantomClass, NumPhantoms, BehaviorTree, Seconds, BaselineMs);
+	}
+	Report->SetObjectField(TEXT("Phases"), Phases);
+
+	auto Subsystems = MakeShared<FJsonObject>();
+	Subsystems->SetObjectField(TEXT("ActorPool"), StatsToJson(World->GetSubsystem<UPhantoActorPoolSubsystem>()->GetTotalStats()));
+	if (auto Scheduler = World->GetSubsystem<UPhantoNavBuildSchedulerSubsystem>())
+		Subsystems->SetObjectField(TEXT("NavBuildScheduler"), StatsToJson(Scheduler->GetStats()));
+	if (auto PathRequests = World->GetSubsystem<UPhantoPathRequestSubsystem>())
+		Subsystems->SetObjectField(TEXT("PathRequests"), StatsToJson(PathRequests->GetStats()));
+	Report->SetObjectField(TEXT("Subsystems"), Subsystems);
+
+	auto const MemoryStats = FPlatformMemory::GetStats();
+	auto Memory = MakeShared<FJsonObject>();
+	Memory->SetNumberField(TEXT("PeakUsedPhysicalMB"), FMath::Max(PeakUsedPhysical, MemoryStats.PeakUsedPhysical) * BytesToMB);
+	Memory->SetNumberField(TEXT("PeakUsedVirtualMB"), MemoryStats.PeakUsedVirtual * BytesToMB);
+	Memory->SetNumberField(TEXT("UsedPhysicalMB"), MemoryStats.UsedPhysical * BytesToMB);
+	Report->SetObjectField(TEXT("Memory"), Memory);
+
+	DestroyBenchWorld(*World);
+
+	FString Json;
+	auto Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+	if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogPhanto, Error, TEXT("PhantoBench: couldn't write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogPhanto, Display, TEXT("PhantoBench: report written to %s"), *FPaths::ConvertRelativePathToFull(OutputPath));
+	return 0;
+}
@@ -3,10 +3,28 @@
 
 #include "PhantoBlueprintFunctionLibrary.h"
 
+#include "AI/NavDataGenerator.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "NavigationData.h"
 #include "NavLinkCustomComponent.h"
 #include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
 #include "Navigation/PathFollowingComponent.h"
+#include "Phanto.h"
+#include "PhantoFlightNavigationSubsystem.h"
+#include "PhantoNavBuildSchedulerSubsystem.h"
+#include "PhantoNavigationSubsystem.h"
+#include "PhantoReplaySceneActor.h"
+#include "PhantoSceneAnchorRegistry.h"
+#include "PhantoSceneBVHSubsystem.h"
+#include "PhantoSceneCapture.h"
+#include "PhantoSurfaceSampleSubsystem.h"
+#include "PhantoVectorMath.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rebuild Navigation Tiles"), STAT_PhantoRebuildNavigationTiles, STATGROUP_Phanto);
+DECLARE_CYCLE_STAT(TEXT("Set Link Data Batch"), STAT_PhantoSetLinkDataBatch, STATGROUP_Phanto);
 
 void UPopulateSceneAsyncAction::Activate()
 {
@@ -19,6 +37,7 @@ void UPopulateSceneAsyncAction::Activate()
 		{
 			if (SceneActor->IsScenePopulated())
 			{
+				FinishScenePopulation(World, SceneActor);
 				OnScenePopulated.Broadcast();
 						
 				auto&& TimerManager = World->GetTimerManager();
@@ -46,6 +65,166 @@ UPopulateSceneAsyncAction* UPopulateSceneAsyncAction::PopulateSceneAsync(AOculus
 	return Action;
 }
 
+void UPopulateSceneAsyncAction::FinishScenePopulation(UWorld* World, AActor* SceneRoot)
+{
+	// Classifications and sizes are set after the anchors begin play.
+	if (auto Registry = World->GetSubsystem<UPhantoSceneAnchorRegistry>())
+		Registry->RefreshAnchors();
+
+	auto SceneBVH = World->GetSubsystem<UPhantoSceneBVHSubsystem>();
+	if (SceneBVH && SceneBVH->bBuildOnScenePopulated)
+		SceneBVH->BuildFromActors({ SceneRoot });
+
+	auto SurfaceSamples = World->GetSubsystem<UPhantoSurfaceSampleSubsystem>();
+	if (SurfaceSamples && SurfaceSamples->bBuildOnScenePopulated)
+		SurfaceSamples->BuildFromActors({ SceneRoot });
+
+	auto FlightNavigation = World->GetSubsystem<UPhantoFlightNavigationSubsystem>();
+	if (FlightNavigation && FlightNavigation->bBuildOnScenePopulated)
+		FlightNavigation->BuildFromActors({ SceneRoot });
+}
+
+void UPopulateReplaySceneAsyncAction::Activate()
+{
+	Super::Activate();
+
+	auto Actor = ReplayActor.Get();
+	auto World = Actor ? Actor->GetWorld() : nullptr;
+	if (!World)
+	{
+		OnFailed.Broadcast();
+		SetReadyToDestroy();
+		return;
+	}
+
+	auto const bPopulated = Actor->IsScenePopulated() || Actor->LoadCapture(Actor->CapturePath);
+	if (bPopulated)
+		UPopulateSceneAsyncAction::FinishScenePopulation(World, Actor);
+
+	// Like the device scene, the result comes after Activate returns.
+	TimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this, bPopulated]
+	{
+		if (bPopulated)
+			OnScenePopulated.Broadcast();
+		else
+			OnFailed.Broadcast();
+		SetReadyToDestroy();
+	}));
+}
+
+UPopulateReplaySceneAsyncAction* UPopulateReplaySceneAsyncAction::PopulateReplaySceneAsync(APhantoReplaySceneActor* ReplayActor)
+{
+	auto Action = NewObject<UPopulateReplaySceneAsyncAction>();
+	Action->ReplayActor = ReplayActor;
+	if (ReplayActor)
+		Action->RegisterWithGameInstance(ReplayActor);
+	return Action;
+}
+
+URebuildNavigationTilesAsyncAction* URebuildNavigationTilesAsyncAction::RebuildNavigationInBounds(UObject* WorldContextObject,
+	const TArray<FBox>& Bounds, float FrameBudgetMs)
+{
+	auto World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	auto Action = NewObject<URebuildNavigationTilesAsyncAction>(World);
+	Action->World = World;
+	Action->DirtyBounds = Bounds;
+	Action->FrameBudgetMs = FrameBudgetMs;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+URebuildNavigationTilesAsyncAction* URebuildNavigationTilesAsyncAction::RebuildNavigationAroundAnchors(UObject* WorldContextObject,
+	const TArray<AActor*>& Anchors, float FrameBudgetMs)
+{
+	TArray<FBox> Bounds;
+	Bounds.Reserve(Anchors.Num());
+	for (auto Anchor : Anchors)
+	{
+		if (Anchor)
+		{
+			auto const AnchorBounds = Anchor->GetComponentsBoundingBox(true);
+			if (AnchorBounds.IsValid)
+				Bounds.Add(AnchorBounds);
+		}
+	}
+	return RebuildNavigationInBounds(WorldContextObject, Bounds, FrameBudgetMs);
+}
+
+void URebuildNavigationTilesAsyncAction::Activate()
+{
+	Super::Activate();
+
+	StartTime = FPlatformTime::Seconds();
+
+	auto NavSystem = UNavigationSystemV1::GetNavigationSystem(World.Get());
+	auto NavMesh = NavSystem ? NavSystem->GetDefaultNavDataInstance() : nullptr;
+	if (!NavMesh || !NavMesh->GetGenerator())
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("RebuildNavigationInBounds: no navigation data with runtime generation available"));
+		Finish();
+		return;
+	}
+
+	NavData = NavMesh;
+	NumTiles = UPhantoBlueprintFunctionLibrary::GatherDirtyTiles(*NavMesh, DirtyBounds, PendingTiles);
+
+	TickRebuild();
+}
+
+void URebuildNavigationTilesAsyncAction::TickRebuild()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoRebuildNavigationTiles);
+
+	auto NavMesh = NavData.Get();
+	auto Generator = NavMesh ? NavMesh->GetGenerator() : nullptr;
+	if (!Generator || !World.IsValid())
+	{
+		Finish();
+		return;
+	}
+
+	// Only feed the generator once it caught up with the previous batch, so the tiles of a single
+	// change don't all land in the same frame. Nothing is submitted during gameplay critical sections.
+	auto Scheduler = World->GetSubsystem<UPhantoNavBuildSchedulerSubsystem>();
+	auto const bPaused = Scheduler && Scheduler->IsPaused();
+	auto const RunningTasks = Generator->GetNumRemaningBuildTasks();
+	if (PendingTiles.Num() > 0 && RunningTasks <= TilesPerBatch && !bPaused)
+	{
+		auto const BatchStart = FPlatformTime::Seconds();
+
+		TArray<FNavigationDirtyArea> Batch;
+		while (PendingTiles.Num() > 0 && Batch.Num() < TilesPerBatch)
+		{
+			Batch.Emplace(PendingTiles.Pop(EAllowShrinking::No), ENavigationDirtyFlag::All);
+		}
+		NavMesh->RebuildDirtyAreas(Batch);
+
+		// Grow the batch while the generator keeps up and submitting stays well within the frame budget,
+		// shrink it as soon as it doesn't.
+		constexpr int32 MaxTilesPerBatch = 16;
+		auto const BatchMs = (FPlatformTime::Seconds() - BatchStart) * 1000.0;
+		TilesPerBatch = BatchMs < FrameBudgetMs * 0.5 && RunningTasks == 0
+			? FMath::Min(TilesPerBatch * 2, MaxTilesPerBatch)
+			: FMath::Max(1, TilesPerBatch / 2);
+	}
+	else if (PendingTiles.Num() == 0 && !Generator->IsBuildInProgressCheckDirty())
+	{
+		Finish();
+		return;
+	}
+
+	TimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this] { TickRebuild(); }));
+}
+
+void URebuildNavigationTilesAsyncAction::Finish()
+{
+	auto const DurationMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	UE_LOG(LogPhanto, Log, TEXT("Rebuilt %d navigation tiles in %.2f ms"), NumTiles, DurationMs);
+
+	OnRebuilt.Broadcast(NumTiles, DurationMs);
+	SetReadyToDestroy();
+}
+
 FString UPhantoBlueprintFunctionLibrary::Repeat(FString String, int Count)
 {
 	FString RepeatedString(FString(), Count * String.Len());
@@ -56,7 +235,8 @@ FString UPhantoBlueprintFunctionLibrary::Repeat(FString String, int Count)
 
 double UPhantoBlueprintFunctionLibrary::AngleBetweenRadians(FVector const & A, FVector const & B)
 {
-	return FMath::Acos(A.Dot(B));
+	// Slightly denormalized inputs would push the dot product out of the domain of acos.
+	return FMath::Acos(FMath::Clamp(A.Dot(B), -1.0, 1.0));
 }
 
 double UPhantoBlueprintFunctionLibrary::AngleBetween(FVector const & A, FVector const & B)
@@ -64,6 +244,45 @@ double UPhantoBlueprintFunctionLibrary::AngleBetween(FVector const & A, FVector
 	return FMath::RadiansToDegrees(AngleBetweenRadians(A, B));
 }
 
+void UPhantoBlueprintFunctionLibrary::AnglesBetween(TArray<FVector> const & A, TArray<FVector> const & B, TArray<double>& Degrees)
+{
+	Degrees.Reset();
+	if (A.Num() != B.Num())
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("AnglesBetween: A has %d vectors and B %d"), A.Num(), B.Num());
+		return;
+	}
+
+	TArray<float, TInlineAllocator<64>> Radians;
+	Radians.SetNumUninitialized(A.Num());
+	PhantoVectorMath::AnglesBetween(A, B, Radians);
+
+	Degrees.Reserve(Radians.Num());
+	for (auto const Angle : Radians)
+	{
+		Degrees.Add(FMath::RadiansToDegrees(Angle));
+	}
+}
+
+void UPhantoBlueprintFunctionLibrary::AnglesToDirection(FVector const & Direction, TArray<FVector> const & Vectors, TArray<double>& Degrees)
+{
+	TArray<float, TInlineAllocator<64>> Radians;
+	Radians.SetNumUninitialized(Vectors.Num());
+	PhantoVectorMath::AnglesTo(Direction, Vectors, Radians);
+
+	Degrees.Reset(Radians.Num());
+	for (auto const Angle : Radians)
+	{
+		Degrees.Add(FMath::RadiansToDegrees(Angle));
+	}
+}
+
+void UPhantoBlueprintFunctionLibrary::FindInCone(FVector const & Origin, FVector const & Direction, double HalfAngleDegrees, TArray<FVector> const & Locations, TArray<int32>& Indices, double MaxDistance)
+{
+	Indices.Reset();
+	PhantoVectorMath::FindInCone(Origin, Direction, FMath::DegreesToRadians(float(HalfAngleDegrees)), float(MaxDistance), Locations, Indices);
+}
+
 UObject* UPhantoBlueprintFunctionLibrary::DynamicCast(UObject* Object, TSubclassOf<UObject> TargetClass, bool & IsValid)
 {
 	IsValid = Object && Object->GetClass()->IsChildOf(TargetClass);
@@ -93,6 +312,146 @@ void UPhantoBlueprintFunctionLibrary::SetLinkData(
 	}
 }
 
+void UPhantoBlueprintFunctionLibrary::SetLinkDataBatch(
+	const TArray<UNavLinkCustomComponent*>& NavLinks,
+	const TArray<FVector>& RelativeStarts,
+	const TArray<FVector>& RelativeEnds,
+	const TArray<TEnumAsByte<ENavLinkDirection::Type>>& Directions)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoSetLinkDataBatch);
+
+	auto const Num = NavLinks.Num();
+	if (RelativeStarts.Num() != Num || RelativeEnds.Num() != Num || Directions.Num() != Num)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("SetLinkDataBatch: got %d links but %d starts, %d ends and %d directions"),
+			Num, RelativeStarts.Num(), RelativeEnds.Num(), Directions.Num());
+		return;
+	}
+
+	auto FirstLink = NavLinks.FindByPredicate([](auto NavLink) { return NavLink != nullptr; });
+	if (!FirstLink)
+		return;
+
+	auto NavSys = UNavigationSystemV1::GetNavigationSystem(*FirstLink);
+	if (!NavSys)
+	{
+		for (int32 i = 0; i < Num; ++i)
+		{
+			if (NavLinks[i])
+				SetLinkData(NavLinks[i], RelativeStarts[i], RelativeEnds[i], Directions[i]);
+		}
+		return;
+	}
+
+	// With the octree locked, SetLinkData and ForceNavigationRelevancy don't each update the octree
+	// (and dirty the link's tiles) on their own.
+	auto const bWasOctreeLocked = NavSys->IsNavigationOctreeLocked();
+	NavSys->SetNavigationOctreeLock(true);
+
+	FBox DirtyArea(ForceInit);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		auto NavLink = NavLinks[i];
+		if (!NavLink)
+			continue;
+
+		NavLink->Activate();
+		NavLink->SetLinkData(RelativeStarts[i], RelativeEnds[i], Directions[i]);
+		NavLink->ForceNavigationRelevancy(true);
+
+		if (NavSys->GetCustomLink(NavLink->GetId()) != NavLink)
+		{
+			NavSys->RegisterCustomLink(*NavLink);
+		}
+		else if (bWasOctreeLocked)
+		{
+			// A locked octree keeps the old link data, rebuilds wouldn't pick up the change.
+			NavSys->UpdateCustomLink(NavLink);
+		}
+
+		if (auto Owner = NavLink->GetOwner())
+		{
+			auto const Link = NavLink->GetLinkModifier();
+			auto const& Transform = Owner->GetActorTransform();
+			DirtyArea += FBox::BuildAABB(Transform.TransformPosition(Link.Left), FVector(Link.SnapRadius));
+			DirtyArea += FBox::BuildAABB(Transform.TransformPosition(Link.Right), FVector(Link.SnapRadius));
+		}
+	}
+
+	NavSys->SetNavigationOctreeLock(bWasOctreeLocked);
+
+	// The octree has to hold the new link data for the rebuild to gather it. Refreshing each element dirties its own
+	// bounds too, those fall inside the union below and are merged with it by the generator.
+	if (!bWasOctreeLocked)
+	{
+		for (auto NavLink : NavLinks)
+		{
+			if (NavLink)
+				FNavigationSystem::UpdateComponentData(*NavLink);
+		}
+	}
+
+	if (DirtyArea.IsValid)
+		NavSys->AddDirtyArea(DirtyArea, ENavigationDirtyFlag::All, nullptr, TEXT("SetLinkDataBatch"));
+}
+
+void UPhantoBlueprintFunctionLibrary::OptimizeLinkSet(
+	const TArray<UNavLinkCustomComponent*>& NavLinks,
+	const FPhantoNavLinkMergeSettings& Settings,
+	TArray<UNavLinkCustomComponent*>& RemovedLinks,
+	int32& NumLinksBefore,
+	int32& NumLinksAfter)
+{
+	TArray<UNavLinkCustomComponent*> ValidLinks;
+	TArray<FPhantoNavLinkSetOptimizer::FLink> Links;
+	for (auto NavLink : NavLinks)
+	{
+		if (!NavLink || !NavLink->GetOwner())
+			continue;
+
+		FVector Start, End;
+		TEnumAsByte<ENavLinkDirection::Type> Direction;
+		GetLinkData(NavLink, Start, End, Direction);
+
+		auto const& Transform = NavLink->GetOwner()->GetActorTransform();
+		ValidLinks.Add(NavLink);
+		Links.Add({ Transform.TransformPosition(Start), Transform.TransformPosition(End), Direction });
+	}
+
+	TArray<int32> MergedInto;
+	NumLinksBefore = Links.Num();
+	NumLinksAfter = FPhantoNavLinkSetOptimizer::Optimize(Links, Settings, MergedInto);
+
+	TArray<UNavLinkCustomComponent*> KeptLinks;
+	TArray<FVector> RelativeStarts, RelativeEnds;
+	TArray<TEnumAsByte<ENavLinkDirection::Type>> Directions;
+	auto NavSys = ValidLinks.Num() > 0 ? UNavigationSystemV1::GetNavigationSystem(ValidLinks[0]) : nullptr;
+	for (int32 i = 0; i < ValidLinks.Num(); ++i)
+	{
+		auto NavLink = ValidLinks[i];
+		if (MergedInto[i] != i)
+		{
+			if (NavSys)
+				NavSys->UnregisterCustomLink(*NavLink);
+			NavLink->SetNavigationRelevancy(false);
+			RemovedLinks.Add(NavLink);
+		}
+		else if (Settings.bAverageMergedLinks)
+		{
+			auto const& Transform = NavLink->GetOwner()->GetActorTransform();
+			KeptLinks.Add(NavLink);
+			RelativeStarts.Add(Transform.InverseTransformPosition(Links[i].Start));
+			RelativeEnds.Add(Transform.InverseTransformPosition(Links[i].End));
+			Directions.Add(Links[i].Direction);
+		}
+	}
+
+	if (KeptLinks.Num() > 0 && NumLinksAfter < NumLinksBefore)
+		SetLinkDataBatch(KeptLinks, RelativeStarts, RelativeEnds, Directions);
+
+	UE_LOG(LogPhanto, Log, TEXT("OptimizeLinkSet: %d links before, %d after"), NumLinksBefore, NumLinksAfter);
+}
+
 void UPhantoBlueprintFunctionLibrary::GetLinkData(const UNavLinkCustomComponent* NavLink, FVector& LeftPt, FVector& RightPt, TEnumAsByte<ENavLinkDirection::Type>& Direction)
 {
 	ENavLinkDirection::Type DirectionEnum;
@@ -118,6 +477,90 @@ void UPhantoBlueprintFunctionLibrary::RebuildAll(UObject* WorldContextObject)
 	NavMesh->RebuildAll();
 }
 
+int32 UPhantoBlueprintFunctionLibrary::GatherDirtyTiles(const ANavigationData& NavData, TConstArrayView<FBox> Bounds, TArray<FBox>& OutTileBounds)
+{
+	auto const AgentRadius = NavData.GetConfig().AgentRadius;
+
+	TArray<FBox> ExpandedBounds;
+	ExpandedBounds.Reserve(Bounds.Num());
+	for (auto const& Box : Bounds)
+	{
+		if (Box.IsValid)
+			ExpandedBounds.Add(Box.ExpandBy(AgentRadius));
+	}
+
+	auto RecastNavMesh = Cast<ARecastNavMesh>(&NavData);
+	if (!RecastNavMesh)
+	{
+		OutTileBounds.Append(ExpandedBounds);
+		return ExpandedBounds.Num();
+	}
+
+	TArray<int32> TileIndices;
+	RecastNavMesh->GetNavMeshTilesIn(ExpandedBounds, TileIndices);
+
+	TSet<FIntPoint> VisitedTiles;
+	TArray<double> CoveredAreas;
+	TArray<int32> NumCoveringTiles;
+	CoveredAreas.SetNumZeroed(ExpandedBounds.Num());
+	NumCoveringTiles.SetNumZeroed(ExpandedBounds.Num());
+	for (auto const TileIndex : TileIndices)
+	{
+		int32 X, Y, Layer;
+		if (!RecastNavMesh->GetNavMeshTileXY(TileIndex, X, Y, Layer))
+			continue;
+
+		bool bAlreadyVisited;
+		VisitedTiles.Add(FIntPoint(X, Y), &bAlreadyVisited);
+		if (bAlreadyVisited)
+			continue;
+
+		// Clip the changed bounds to the tile footprint, so the generator only re-gathers geometry it needs.
+		auto const TileBounds = RecastNavMesh->GetNavMeshTileBounds(TileIndex);
+		FBox TileDirtyArea(ForceInit);
+		for (int32 i = 0; i < ExpandedBounds.Num(); ++i)
+		{
+			auto const& Box = ExpandedBounds[i];
+			if (Box.Min.X > TileBounds.Max.X || Box.Max.X < TileBounds.Min.X || Box.Min.Y > TileBounds.Max.Y || Box.Max.Y < TileBounds.Min.Y)
+				continue;
+
+			auto const Clipped = FBox(
+				FVector(FMath::Max(Box.Min.X, TileBounds.Min.X), FMath::Max(Box.Min.Y, TileBounds.Min.Y), Box.Min.Z),
+				FVector(FMath::Min(Box.Max.X, TileBounds.Max.X), FMath::Min(Box.Max.Y, TileBounds.Max.Y), Box.Max.Z));
+			TileDirtyArea += Clipped;
+
+			// Tile footprints don't overlap, their clipped areas add up to the part of the bounds they cover.
+			auto const Size = Clipped.GetSize();
+			if (Size.X > 0 && Size.Y > 0)
+			{
+				CoveredAreas[i] += Size.X * Size.Y;
+				++NumCoveringTiles[i];
+			}
+		}
+
+		if (TileDirtyArea.IsValid)
+			OutTileBounds.Add(TileDirtyArea);
+	}
+
+	// Bounds reaching past the existing tiles (e.g. the room grew, or new furniture at the edge of the navmesh) are
+	// passed whole as well, the generator creates the missing tiles.
+	auto NumTiles = VisitedTiles.Num();
+	auto const TileSize = RecastNavMesh->GetTileSizeUU();
+	for (int32 i = 0; i < ExpandedBounds.Num(); ++i)
+	{
+		auto const Size = ExpandedBounds[i].GetSize();
+		auto const Area = Size.X * Size.Y;
+		if (NumCoveringTiles[i] > 0 && CoveredAreas[i] >= Area * (1 - UE_KINDA_SMALL_NUMBER))
+			continue;
+
+		OutTileBounds.Add(ExpandedBounds[i]);
+		auto const NumSpanned = FMath::CeilToInt(Size.X / TileSize) * FMath::CeilToInt(Size.Y / TileSize);
+		NumTiles += FMath::Max(NumSpanned - NumCoveringTiles[i], 1);
+	}
+
+	return NumTiles;
+}
+
 void UPhantoBlueprintFunctionLibrary::SetRebuildingSuspended(UObject* WorldContextObject, const bool bNewSuspend)
 {
 	auto NavSystem = UNavigationSystemV1::GetNavigationSystem(WorldContextObject);
@@ -144,14 +587,6 @@ void UPhantoBlueprintFunctionLibrary::ConfigureNavigationSystemAsStatic(bool bIs
 
 void UPhantoBlueprintFunctionLibrary::SetNavigationRuntimeGenerationMode(UObject* WorldContextObject, ERuntimeGenerationType Mode)
 {
-	struct AUnprotectedNavigationData : ANavigationData
-	{
-		void SetRuntimeGenerationMode(ERuntimeGenerationType Mode)
-		{
-			RuntimeGeneration = Mode;
-		}
-	};
-
 	auto NavSystem = UNavigationSystemV1::GetNavigationSystem(WorldContextObject);
 	if (!NavSystem)
 		return;
@@ -160,9 +595,7 @@ void UPhantoBlueprintFunctionLibrary::SetNavigationRuntimeGenerationMode(UObject
 	if (!NavMesh)
 		return;
 
-	((AUnprotectedNavigationData*)NavMesh)->SetRuntimeGenerationMode(Mode);
-
-	NavSystem->SetNavigationOctreeLock(Mode != ERuntimeGenerationType::Dynamic);
+	UPhantoNavigationSubsystem::SetRuntimeGenerationMode(*NavMesh, Mode);
 }
 
 ERuntimeGenerationType UPhantoBlueprintFunctionLibrary::GetNavigationRuntimeGenerationMode(UObject* WorldContextObject)
@@ -185,3 +618,121 @@ void UPhantoBlueprintFunctionLibrary::SetPreciseReachThreshold(UPathFollowingCom
 		Component->SetPreciseReachThreshold(AgentRadiusMultiplier, AgentHalfHeightMultiplier);
 	}
 }
+
+bool UPhantoBlueprintFunctionLibrary::CaptureSceneToFile(AActor* SceneActor, const FString& Path)
+{
+	if (!SceneActor)
+		return false;
+
+	return PhantoSceneCapture::CaptureToFile({ SceneActor }, Path.IsEmpty() ? PhantoSceneCapture::MakeCapturePath() : Path);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkLinkRegistrationCommand(
+	TEXT("Phanto.Nav.BenchmarkLinkRegistration"),
+	TEXT("Compares SetLinkData called once per link with SetLinkDataBatch, including the tile rebuilds they trigger. Usage: Phanto.Nav.BenchmarkLinkRegistration [NumLinks=256]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](TArray<FString> const& Args, UWorld* World)
+	{
+		auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(World);
+		if (!NavSystem)
+			return;
+
+		auto const NumLinks = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 256;
+
+		auto SpawnLinks = [World, NumLinks](TArray<TWeakObjectPtr<UNavLinkCustomComponent>>& OutLinks)
+		{
+			auto Actor = World->SpawnActor<AActor>();
+			Actor->SetRootComponent(NewObject<USceneComponent>(Actor));
+			Actor->GetRootComponent()->RegisterComponent();
+			for (int32 i = 0; i < NumLinks; ++i)
+			{
+				auto NavLink = NewObject<UNavLinkCustomComponent>(Actor);
+				NavLink->RegisterComponent();
+				OutLinks.Add(NavLink);
+			}
+			return Actor;
+		};
+
+		struct FBenchmark
+		{
+			TWeakObjectPtr<UNavigationSystemV1> NavSystem;
+			TWeakObjectPtr<AActor> SingleActor;
+			TWeakObjectPtr<AActor> BatchActor;
+			TArray<TWeakObjectPtr<UNavLinkCustomComponent>> SingleLinks;
+			TArray<TWeakObjectPtr<UNavLinkCustomComponent>> BatchLinks;
+			TArray<FVector> Starts;
+			TArray<FVector> Ends;
+			TArray<TEnumAsByte<ENavLinkDirection::Type>> Directions;
+
+			/** 0 waits for the links to be registered, 1 rebuilds after SetLinkData, 2 after SetLinkDataBatch. */
+			int32 Step = 0;
+			double SetMs[2] = {};
+			double RebuildStart = 0;
+			double RebuildMs[2] = {};
+		};
+
+		auto Benchmark = MakeShared<FBenchmark>();
+		Benchmark->NavSystem = NavSystem;
+		for (int32 i = 0; i < NumLinks; ++i)
+		{
+			auto const Offset = FVector(i % 16, i / 16, 0) * 50.0;
+			Benchmark->Starts.Add(Offset + FVector(0, 0, 50));
+			Benchmark->Ends.Add(Offset + FVector(40, 0, 0));
+			Benchmark->Directions.Add(ENavLinkDirection::LeftToRight);
+		}
+
+		Benchmark->SingleActor = SpawnLinks(Benchmark->SingleLinks);
+		Benchmark->BatchActor = SpawnLinks(Benchmark->BatchLinks);
+
+		// The cost is mostly in the tile rebuilds the links trigger, which run over the next frames: each step waits
+		// for the build to finish, the rebuild time is the wall time until then.
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Benchmark](float DeltaTime)
+		{
+			auto NavSystem = Benchmark->NavSystem.Get();
+			if (!NavSystem)
+				return false;
+
+			if (NavSystem->IsNavigationBuildInProgress() || NavSystem->HasDirtyAreasQueued())
+				return true;
+
+			if (Benchmark->Step > 0)
+				Benchmark->RebuildMs[Benchmark->Step - 1] = (FPlatformTime::Seconds() - Benchmark->RebuildStart) * 1000.0;
+
+			auto const Step = Benchmark->Step++;
+			if (Step < 2)
+			{
+				TArray<UNavLinkCustomComponent*> NavLinks;
+				for (auto const& NavLink : Step == 0 ? Benchmark->SingleLinks : Benchmark->BatchLinks)
+				{
+					NavLinks.Add(NavLink.Get());
+				}
+
+				auto const SetStart = FPlatformTime::Seconds();
+				if (Step == 0)
+				{
+					for (int32 i = 0; i < NavLinks.Num(); ++i)
+					{
+						UPhantoBlueprintFunctionLibrary::SetLinkData(NavLinks[i], Benchmark->Starts[i], Benchmark->Ends[i], Benchmark->Directions[i]);
+					}
+				}
+				else
+				{
+					UPhantoBlueprintFunctionLibrary::SetLinkDataBatch(NavLinks, Benchmark->Starts, Benchmark->Ends, Benchmark->Directions);
+				}
+				Benchmark->RebuildStart = FPlatformTime::Seconds();
+				Benchmark->SetMs[Step] = (Benchmark->RebuildStart - SetStart) * 1000.0;
+				return true;
+			}
+
+			auto const SingleMs = Benchmark->SetMs[0] + Benchmark->RebuildMs[0];
+			auto const BatchMs = Benchmark->SetMs[1] + Benchmark->RebuildMs[1];
+			UE_LOG(LogPhanto, Display, TEXT("Link registration, %d links: per-link %.3f ms (set %.3f, rebuild %.3f), batch %.3f ms (set %.3f, rebuild %.3f) (%.1fx)"),
+				Benchmark->Starts.Num(), SingleMs, Benchmark->SetMs[0], Benchmark->RebuildMs[0], BatchMs, Benchmark->SetMs[1], Benchmark->RebuildMs[1],
+				BatchMs > 0 ? SingleMs / BatchMs : 0.0);
+
+			if (auto SingleActor = Benchmark->SingleActor.Get())
+				SingleActor->Destroy();
+			if (auto BatchActor = Benchmark->BatchActor.Get())
+				BatchActor->Destroy();
+			return false;
+		}));
+	}));
@@ -0,0 +1,68 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoFlightNavigationSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Phanto.h"
+#include "PhantoFlightOctree.h"
+#include "PhantoSceneGeometry.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flight Octree Build"), STAT_PhantoFlightOctreeBuild, STATGROUP_Phanto);
+DECLARE_MEMORY_STAT(TEXT("Flight Octree Memory"), STAT_PhantoFlightOctreeMemory, STATGROUP_Phanto);
+
+float UPhantoFlightNavigationSubsystem::BuildFromBounds(const FBox& Bounds, float VoxelSize, TEnumAsByte<ECollisionChannel> TraceChannel)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoFlightOctreeBuild);
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("BuildFromBounds: invalid bounds, flight octree not built"));
+		return 0;
+	}
+
+	auto const StartTime = FPlatformTime::Seconds();
+	auto NewOctree = MakeShared<FPhantoFlightOctree>();
+	NewOctree->Build(*GetWorld(), Bounds, VoxelSize, TraceChannel);
+	Octree = NewOctree;
+
+	auto const BuildMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	SET_MEMORY_STAT(STAT_PhantoFlightOctreeMemory, Octree->GetAllocatedSize());
+	UE_LOG(LogPhanto, Log, TEXT("Flight octree built in %.2f ms: %d nodes, %d leaves, %llu bytes"),
+		BuildMs, Octree->GetNumNodes(), Octree->GetNumLeaves(), uint64(Octree->GetAllocatedSize()));
+	return BuildMs;
+}
+
+float UPhantoFlightNavigationSubsystem::BuildFromActors(const TArray<AActor*>& Actors, float VoxelSize, TEnumAsByte<ECollisionChannel> TraceChannel)
+{
+	// The scene actor spawns the room and its anchors as separate actors it owns.
+	TArray<AActor*> SceneActors;
+	PhantoSceneGeometry::GatherSceneActors(Actors, SceneActors);
+
+	FBox Bounds(ForceInit);
+	for (auto Actor : SceneActors)
+	{
+		if (Actor)
+			Bounds += Actor->GetComponentsBoundingBox(true);
+	}
+
+	// Leave room to fly around the outside of the furthest geometry.
+	return BuildFromBounds(Bounds.IsValid ? Bounds.ExpandBy(VoxelSize) : Bounds, VoxelSize, TraceChannel);
+}
+
+void UPhantoFlightNavigationSubsystem::Clear()
+{
+	Octree.Reset();
+	SET_MEMORY_STAT(STAT_PhantoFlightOctreeMemory, 0);
+}
+
+bool UPhantoFlightNavigationSubsystem::IsLocationFree(const FVector& Location) const
+{
+	return Octree && Octree->IsLocationFree(Location);
+}
+
+bool UPhantoFlightNavigationSubsystem::FindPath(const FVector& Start, const FVector& End, TArray<FVector>& OutPath) const
+{
+	return Octree && Octree->FindPath(Start, End, OutPath);
+}
@@ -0,0 +1,357 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoFlightOctree.h"
+
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+namespace PhantoFlightOctree
+{
+	constexpr int32 MaxDepth = 10;
+
+	uint32 Part1By2(uint32 N)
+	{
+		N &= 0x000003ff;
+		N = (N ^ (N << 16)) & 0xff0000ff;
+		N = (N ^ (N << 8)) & 0x0300f00f;
+		N = (N ^ (N << 4)) & 0x030c30c3;
+		N = (N ^ (N << 2)) & 0x09249249;
+		return N;
+	}
+
+	uint32 Compact1By2(uint32 N)
+	{
+		N &= 0x09249249;
+		N = (N ^ (N >> 2)) & 0x030c30c3;
+		N = (N ^ (N >> 4)) & 0x0300f00f;
+		N = (N ^ (N >> 8)) & 0xff0000ff;
+		N = (N ^ (N >> 16)) & 0x000003ff;
+		return N;
+	}
+
+	FIntVector MortonDecode(uint32 Code)
+	{
+		return FIntVector(Compact1By2(Code), Compact1By2(Code >> 1), Compact1By2(Code >> 2));
+	}
+
+	uint32 PackBrick(const FIntVector& Brick)
+	{
+		return uint32(Brick.X) | (uint32(Brick.Y) << MaxDepth) | (uint32(Brick.Z) << (2 * MaxDepth));
+	}
+
+	FIntVector UnpackBrick(uint32 Key)
+	{
+		constexpr uint32 Mask = (1u << MaxDepth) - 1;
+		return FIntVector(Key & Mask, (Key >> MaxDepth) & Mask, Key >> (2 * MaxDepth));
+	}
+}
+
+void FPhantoFlightOctree::Build(const UWorld& World, const FBox& InBounds, float InVoxelSize, ECollisionChannel Channel)
+{
+	using namespace PhantoFlightOctree;
+
+	VoxelSize = FMath::Max(InVoxelSize, 1.f);
+	BrickSize = VoxelSize * 4;
+
+	auto const BricksPerAxis = FMath::Max(1, FMath::CeilToInt(InBounds.GetSize().GetMax() / BrickSize));
+	Depth = FMath::Clamp(int32(FMath::CeilLogTwo(uint32(BricksPerAxis))), 1, MaxDepth);
+	Bounds = FBox(InBounds.Min, InBounds.Min + FVector(BrickSize * (1 << Depth)));
+
+	Layers.Reset();
+	Layers.SetNum(Depth + 1);
+	Leaves.Reset();
+
+	// Physics scene queries only take a read lock, they can run on worker threads while the game thread waits.
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(PhantoFlightOctree), false);
+	auto IsBoxBlocked = [&](const FVector& Min, double Size)
+	{
+		auto const HalfSize = FVector(Size * 0.5);
+		return World.OverlapBlockingTestByChannel(Min + HalfSize, FQuat::Identity, Channel, FCollisionShape::MakeBox(HalfSize), Params);
+	};
+
+	// Top-down: only the children of blocked nodes are tested. Children are appended in octant order after
+	// their sorted parents, so the codes stay sorted in Morton order.
+	TArray<uint32> Codes = { 0 };
+	for (int32 Layer = Depth; Layer > 0 && Codes.Num() > 0; --Layer)
+	{
+		auto const ChildSize = BrickSize * (1 << (Layer - 1));
+
+		TArray<bool> Blocked;
+		Blocked.SetNumZeroed(Codes.Num() * 8);
+		ParallelFor(Blocked.Num(), [&](int32 Index)
+		{
+			auto const Code = (Codes[Index / 8] << 3) | (Index % 8);
+			Blocked[Index] = IsBoxBlocked(Bounds.Min + FVector(MortonDecode(Code)) * ChildSize, ChildSize);
+		});
+
+		TArray<uint32> ChildCodes;
+		for (int32 Index = 0; Index < Blocked.Num(); ++Index)
+		{
+			if (Blocked[Index])
+				ChildCodes.Add((Codes[Index / 8] << 3) | (Index % 8));
+		}
+		Codes = MoveTemp(ChildCodes);
+	}
+
+	TArray<uint64> Masks;
+	Masks.SetNumZeroed(Codes.Num());
+	ParallelFor(Codes.Num(), [&](int32 Index)
+	{
+		auto const BrickMin = Bounds.Min + FVector(MortonDecode(Codes[Index])) * BrickSize;
+		uint64 Mask = 0;
+		for (int32 Voxel = 0; Voxel < 64; ++Voxel)
+		{
+			auto const Offset = FVector(Voxel & 3, (Voxel >> 2) & 3, Voxel >> 4) * VoxelSize;
+			if (IsBoxBlocked(BrickMin + Offset, VoxelSize))
+				Mask |= uint64(1) << Voxel;
+		}
+		Masks[Index] = Mask;
+	});
+
+	// Bricks that only touch geometry on their faces end up without any blocked voxel.
+	TArray<uint32> ChildCodes;
+	for (int32 Index = 0; Index < Codes.Num(); ++Index)
+	{
+		if (Masks[Index])
+		{
+			ChildCodes.Add(Codes[Index]);
+			Leaves.Add(Masks[Index]);
+		}
+	}
+
+	for (int32 Layer = 1; Layer <= Depth; ++Layer)
+	{
+		auto& Nodes = Layers[Layer];
+		TArray<uint32> ParentCodes;
+		for (int32 Index = 0; Index < ChildCodes.Num(); ++Index)
+		{
+			auto const Parent = ChildCodes[Index] >> 3;
+			if (ParentCodes.Num() == 0 || ParentCodes.Last() != Parent)
+			{
+				ParentCodes.Add(Parent);
+				Nodes.Add(FNode::Make(Index));
+			}
+			Nodes.Last().AddChild(ChildCodes[Index] & 7);
+		}
+		ChildCodes = MoveTemp(ParentCodes);
+	}
+}
+
+SIZE_T FPhantoFlightOctree::GetAllocatedSize() const
+{
+	auto Size = Leaves.GetAllocatedSize() + Layers.GetAllocatedSize();
+	for (auto const& Nodes : Layers)
+	{
+		Size += Nodes.GetAllocatedSize();
+	}
+	return Size;
+}
+
+int32 FPhantoFlightOctree::GetNumNodes() const
+{
+	int32 NumNodes = 0;
+	for (auto const& Nodes : Layers)
+	{
+		NumNodes += Nodes.Num();
+	}
+	return NumNodes;
+}
+
+bool FPhantoFlightOctree::IsLocationFree(const FVector& Location) const
+{
+	auto const Brick = GetBrick(Location);
+	auto const Leaf = FindLeaf(Brick);
+	if (Leaf == INDEX_NONE)
+		return true;
+	if (Leaf < 0)
+		return false;
+
+	auto const VoxelX = FMath::Clamp(FMath::FloorToInt((Location.X - Bounds.Min.X) / VoxelSize) - Brick.X * 4, 0, 3);
+	auto const VoxelY = FMath::Clamp(FMath::FloorToInt((Location.Y - Bounds.Min.Y) / VoxelSize) - Brick.Y * 4, 0, 3);
+	auto const VoxelZ = FMath::Clamp(FMath::FloorToInt((Location.Z - Bounds.Min.Z) / VoxelSize) - Brick.Z * 4, 0, 3);
+	return !(Leaves[Leaf] & (uint64(1) << (VoxelX + VoxelY * 4 + VoxelZ * 16)));
+}
+
+bool FPhantoFlightOctree::FindPath(const FVector& Start, const FVector& End, TArray<FVector>& OutPath, int32 MaxIterations) const
+{
+	using namespace PhantoFlightOctree;
+
+	static const TArray<TPair<FIntVector, float>> Neighbors = []
+	{
+		TArray<TPair<FIntVector, float>> Offsets;
+		for (int32 Z = -1; Z <= 1; ++Z)
+			for (int32 Y = -1; Y <= 1; ++Y)
+				for (int32 X = -1; X <= 1; ++X)
+					if (X || Y || Z)
+						Offsets.Emplace(FIntVector(X, Y, Z), FMath::Sqrt(float(X * X + Y * Y + Z * Z)));
+		return Offsets;
+	}();
+
+	// Endpoints are often right against a surface; start from the closest free neighbor in that case.
+	auto FindFreeBrick = [this](const FVector& Location, FIntVector& OutBrick)
+	{
+		OutBrick = GetBrick(Location);
+		if (!IsBrickBlocked(OutBrick))
+			return true;
+
+		auto BestDistance = TNumericLimits<double>::Max();
+		auto const Brick = OutBrick;
+		for (auto const& Neighbor : Neighbors)
+		{
+			auto const Candidate = Brick + Neighbor.Key;
+			auto const Distance = FVector::DistSquared(GetBrickCenter(Candidate), Location);
+			if (!IsBrickBlocked(Candidate) && Distance < BestDistance)
+			{
+				OutBrick = Candidate;
+				BestDistance = Distance;
+			}
+		}
+		return BestDistance < TNumericLimits<double>::Max();
+	};
+
+	FIntVector StartBrick, EndBrick;
+	if (!FindFreeBrick(Start, StartBrick) || !FindFreeBrick(End, EndBrick))
+		return false;
+
+	struct FVisit
+	{
+		float Cost;
+		uint32 Parent;
+		bool bClosed;
+	};
+
+	struct FOpen
+	{
+		float Estimate;
+		uint32 Key;
+
+		bool operator<(const FOpen& Other) const { return Estimate < Other.Estimate; }
+	};
+
+	auto Heuristic = [&EndBrick](const FIntVector& Brick)
+	{
+		return float(FVector(Brick - EndBrick).Size());
+	};
+
+	auto const StartKey = PackBrick(StartBrick);
+	auto const EndKey = PackBrick(EndBrick);
+
+	TMap<uint32, FVisit> Visits;
+	TArray<FOpen> Open;
+	Visits.Add(StartKey, { 0, StartKey, false });
+	Open.HeapPush({ Heuristic(StartBrick), StartKey });
+
+	bool bFound = false;
+	for (int32 Iteration = 0; Iteration < MaxIterations && Open.Num() > 0; ++Iteration)
+	{
+		FOpen Current;
+		Open.HeapPop(Current, EAllowShrinking::No);
+
+		auto& Visit = Visits[Current.Key];
+		if (Visit.bClosed)
+			continue;
+		Visit.bClosed = true;
+
+		if (Current.Key == EndKey)
+		{
+			bFound = true;
+			break;
+		}
+
+		auto const Brick = UnpackBrick(Current.Key);
+		auto const Cost = Visit.Cost;
+		for (auto const& Neighbor : Neighbors)
+		{
+			auto const Next = Brick + Neighbor.Key;
+			if (IsBrickBlocked(Next))
+				continue;
+
+			auto const NextKey = PackBrick(Next);
+			auto const NextCost = Cost + Neighbor.Value;
+			auto NextVisit = Visits.Find(NextKey);
+			if (NextVisit && (NextVisit->bClosed || NextVisit->Cost <= NextCost))
+				continue;
+
+			Visits.Add(NextKey, { NextCost, Current.Key, false });
+			Open.HeapPush({ NextCost + Heuristic(Next), NextKey });
+		}
+	}
+
+	if (!bFound)
+		return false;
+
+	TArray<FIntVector> Bricks;
+	for (auto Key = EndKey; ; Key = Visits[Key].Parent)
+	{
+		Bricks.Add(UnpackBrick(Key));
+		if (Key == StartKey)
+			break;
+	}
+	Algo::Reverse(Bricks);
+
+	// String pulling: skip every brick that can be seen from the last kept one.
+	// Endpoints moved to a free neighbor are replaced by its center, the blocked brick can't be flown through.
+	OutPath.Reset();
+	OutPath.Add(StartBrick == GetBrick(Start) ? Start : GetBrickCenter(StartBrick));
+	int32 Anchor = 0;
+	for (int32 Index = 2; Index < Bricks.Num(); ++Index)
+	{
+		if (!HasLineOfSight(Bricks[Anchor], Bricks[Index]))
+		{
+			Anchor = Index - 1;
+			OutPath.Add(GetBrickCenter(Bricks[Anchor]));
+		}
+	}
+	OutPath.Add(EndBrick == GetBrick(End) ? End : GetBrickCenter(EndBrick));
+	return true;
+}
+
+FIntVector FPhantoFlightOctree::GetBrick(const FVector& Location) const
+{
+	auto const Local = (Location - Bounds.Min) / BrickSize;
+	return FIntVector(FMath::FloorToInt(Local.X), FMath::FloorToInt(Local.Y), FMath::FloorToInt(Local.Z));
+}
+
+FVector FPhantoFlightOctree::GetBrickCenter(const FIntVector& Brick) const
+{
+	return Bounds.Min + (FVector(Brick) + FVector(0.5)) * BrickSize;
+}
+
+int32 FPhantoFlightOctree::FindLeaf(const FIntVector& Brick) const
+{
+	auto const Resolution = 1 << Depth;
+	if (Brick.X < 0 || Brick.Y < 0 || Brick.Z < 0 || Brick.X >= Resolution || Brick.Y >= Resolution || Brick.Z >= Resolution)
+		return -2;
+
+	if (Leaves.Num() == 0)
+		return INDEX_NONE;
+
+	uint32 Index = 0;
+	for (int32 Layer = Depth; Layer > 0; --Layer)
+	{
+		auto const Node = Layers[Layer][Index];
+		auto const Shift = Layer - 1;
+		auto const Octant = ((Brick.X >> Shift) & 1) | (((Brick.Y >> Shift) & 1) << 1) | (((Brick.Z >> Shift) & 1) << 2);
+		auto const Mask = Node.ChildMask();
+		if (!(Mask & (1u << Octant)))
+			return INDEX_NONE;
+
+		Index = Node.FirstChild() + FMath::CountBits(uint64(Mask & ((1u << Octant) - 1)));
+	}
+	return int32(Index);
+}
+
+bool FPhantoFlightOctree::HasLineOfSight(const FIntVector& From, const FIntVector& To) const
+{
+	auto const Delta = FVector(To - From);
+	auto const Steps = FMath::CeilToInt(Delta.GetAbsMax() * 2);
+	for (int32 Step = 1; Step < Steps; ++Step)
+	{
+		auto const Point = FVector(From) + FVector(0.5) + Delta * (double(Step) / Steps);
+		if (IsBrickBlocked(FIntVector(FMath::FloorToInt(Point.X), FMath::FloorToInt(Point.Y), FMath::FloorToInt(Point.Z))))
+			return false;
+	}
+	return true;
+}
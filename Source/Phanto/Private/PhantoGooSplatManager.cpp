@@ -0,0 +1,222 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoGooSplatManager.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Phanto.h"
+#include "PhantoProjectileManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Goo Splats"), STAT_PhantoGooSplats, STATGROUP_Phanto);
+DECLARE_CYCLE_STAT(TEXT("Goo Splat Cleanup"), STAT_PhantoGooSplatCleanup, STATGROUP_Phanto);
+
+namespace
+{
+	FTransform const HiddenTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+}
+
+APhantoGooSplatManager::APhantoGooSplatManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Splats = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Splats"));
+	Splats->SetMobility(EComponentMobility::Movable);
+	Splats->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Splats->SetCanEverAffectNavigation(false);
+	RootComponent = Splats;
+}
+
+void APhantoGooSplatManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Splats->ClearInstances();
+	TArray<FTransform> Hidden;
+	Hidden.Init(HiddenTransform, MaxSplats);
+	Splats->AddInstances(Hidden, false, true, false);
+
+	Locations.Init(FVector::ZeroVector, MaxSplats);
+	Radii.Init(INDEX_NONE, MaxSplats);
+	Serials.Init(0, MaxSplats);
+	Cells.Init(FIntVector::ZeroValue, MaxSplats);
+	AllocationOrder.Reserve(MaxSplats);
+
+	FreeSlots.Reset(MaxSplats);
+	for (auto Slot = MaxSplats - 1; Slot >= 0; --Slot)
+	{
+		FreeSlots.Add(Slot);
+	}
+
+	if (bSplatProjectileImpacts)
+	{
+		for (TActorIterator<APhantoProjectileManager> It(GetWorld()); It; ++It)
+		{
+			It->OnProjectileImpact.AddUniqueDynamic(this, &APhantoGooSplatManager::HandleProjectileImpact);
+		}
+	}
+}
+
+void APhantoGooSplatManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (TActorIterator<APhantoProjectileManager> It(GetWorld()); It; ++It)
+	{
+		It->OnProjectileImpact.RemoveDynamic(this, &APhantoGooSplatManager::HandleProjectileImpact);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APhantoGooSplatManager::AddSplat(FVector Location, FVector Normal, float Radius)
+{
+	auto const Slot = AllocateSlot();
+	if (Slot == INDEX_NONE)
+		return;
+
+	Radius = FMath::Max(Radius, 0.f);
+	Locations[Slot] = Location;
+	Radii[Slot] = Radius;
+	Serials[Slot] = NextSerial++;
+	Cells[Slot] = GetCell(Location);
+	Grid.FindOrAdd(Cells[Slot]).Add(Slot);
+	AllocationOrder.Emplace(Slot, Serials[Slot]);
+
+	// Drop the consumed and cleaned entries once they outnumber the live ones.
+	if (AllocationOrder.Num() > 2 * MaxSplats)
+	{
+		TArray<TPair<int32, uint32>> Live;
+		Live.Reserve(MaxSplats);
+		for (auto i = AllocationHead; i < AllocationOrder.Num(); ++i)
+		{
+			auto const [QueuedSlot, Serial] = AllocationOrder[i];
+			if (Radii[QueuedSlot] >= 0 && Serials[QueuedSlot] == Serial)
+				Live.Emplace(QueuedSlot, Serial);
+		}
+		AllocationOrder = MoveTemp(Live);
+		AllocationHead = 0;
+	}
+
+	++NumSplats;
+	CoveredArea += UE_PI * Radius * Radius;
+	MaxRadius = FMath::Max(MaxRadius, Radius);
+
+	auto const Rotation = FRotationMatrix::MakeFromZ(Normal.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector)).ToQuat()
+		* FQuat(FVector::UpVector, FMath::FRandRange(0, UE_TWO_PI));
+	Splats->UpdateInstanceTransform(Slot, FTransform(Rotation, Location, FVector(Radius / MeshRadius)), true, true, true);
+	SET_DWORD_STAT(STAT_PhantoGooSplats, NumSplats);
+}
+
+int32 APhantoGooSplatManager::CleanSplatsInSphere(FVector Center, float Radius)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoGooSplatCleanup);
+
+	auto const Reach = Radius + MaxRadius;
+	auto const Min = GetCell(Center - FVector(Reach));
+	auto const Max = GetCell(Center + FVector(Reach));
+
+	TArray<int32, TInlineAllocator<32>> Cleaned;
+	for (auto Z = Min.Z; Z <= Max.Z; ++Z)
+	{
+		for (auto Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			for (auto X = Min.X; X <= Max.X; ++X)
+			{
+				auto Cell = Grid.Find(FIntVector(X, Y, Z));
+				if (!Cell)
+					continue;
+
+				for (auto Slot : *Cell)
+				{
+					if (FVector::DistSquared(Locations[Slot], Center) <= FMath::Square(Radius + Radii[Slot]))
+						Cleaned.Add(Slot);
+				}
+			}
+		}
+	}
+
+	for (auto Slot : Cleaned)
+	{
+		FreeSlot(Slot);
+	}
+
+	SET_DWORD_STAT(STAT_PhantoGooSplats, NumSplats);
+	return Cleaned.Num();
+}
+
+void APhantoGooSplatManager::ClearSplats()
+{
+	for (auto Slot = 0; Slot < Radii.Num(); ++Slot)
+	{
+		if (Radii[Slot] >= 0)
+			FreeSlot(Slot);
+	}
+
+	AllocationOrder.Reset();
+	AllocationHead = 0;
+	CoveredArea = 0;
+	MaxRadius = 0;
+	SET_DWORD_STAT(STAT_PhantoGooSplats, 0);
+}
+
+APhantoGooSplatManager* APhantoGooSplatManager::GetGooSplatManager(const UObject* WorldContext)
+{
+	auto World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World)
+		return nullptr;
+
+	for (TActorIterator<APhantoGooSplatManager> It(World); It; ++It)
+	{
+		return *It;
+	}
+	return nullptr;
+}
+
+int32 APhantoGooSplatManager::AllocateSlot()
+{
+	if (!FreeSlots.IsEmpty())
+		return FreeSlots.Pop(EAllowShrinking::No);
+
+	// Oldest splat still alive under the serial it was queued with.
+	while (AllocationHead < AllocationOrder.Num())
+	{
+		auto const [Slot, Serial] = AllocationOrder[AllocationHead++];
+		if (Radii[Slot] >= 0 && Serials[Slot] == Serial)
+		{
+			FreeSlot(Slot);
+			++NumRecycled;
+			break;
+		}
+	}
+
+	return FreeSlots.IsEmpty() ? INDEX_NONE : FreeSlots.Pop(EAllowShrinking::No);
+}
+
+void APhantoGooSplatManager::FreeSlot(int32 Slot)
+{
+	if (auto Cell = Grid.Find(Cells[Slot]))
+	{
+		Cell->RemoveSingleSwap(Slot, EAllowShrinking::No);
+		if (Cell->IsEmpty())
+			Grid.Remove(Cells[Slot]);
+	}
+
+	--NumSplats;
+	CoveredArea = FMath::Max(CoveredArea - UE_PI * Radii[Slot] * Radii[Slot], 0.f);
+	Radii[Slot] = INDEX_NONE;
+	FreeSlots.Add(Slot);
+	Splats->UpdateInstanceTransform(Slot, HiddenTransform, true, true, true);
+}
+
+FIntVector APhantoGooSplatManager::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void APhantoGooSplatManager::HandleProjectileImpact(const FHitResult& Hit, AActor* Instigator)
+{
+	AddSplat(Hit.ImpactPoint, Hit.ImpactNormal, ProjectileSplatRadius);
+}
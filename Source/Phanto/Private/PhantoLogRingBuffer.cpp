@@ -0,0 +1,40 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoLogRingBuffer.h"
+
+#include "CoreGlobals.h"
+
+FPhantoLogRingBuffer::FPhantoLogRingBuffer(int32 InNumLines, int32 InMaxLineLength)
+	: NumLines(FMath::Max(InNumLines, 1))
+	, MaxLineLength(FMath::Max(InMaxLineLength, 16))
+	, Slots(MakeUnique<FSlot[]>(NumLines))
+	, Text(MakeUnique<TCHAR[]>(SIZE_T(NumLines) * MaxLineLength))
+{
+}
+
+void FPhantoLogRingBuffer::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category)
+{
+	Serialize(V, Verbosity, Category, FPlatformTime::Seconds() - GStartTime);
+}
+
+void FPhantoLogRingBuffer::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category, double Time)
+{
+	auto const Index = WriteCursor.fetch_add(1, std::memory_order_relaxed);
+	auto& Slot = Slots[Index % NumLines];
+	Slot.Sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	auto Line = &Text[(Index % NumLines) * MaxLineLength];
+	int32 Length = 0;
+	for (; Length < MaxLineLength && V[Length]; ++Length)
+	{
+		Line[Length] = V[Length];
+	}
+
+	Slot.Length = Length;
+	Slot.Category = Category;
+	Slot.Verbosity = ELogVerbosity::Type(Verbosity & ELogVerbosity::VerbosityMask);
+	Slot.Time = Time;
+	Slot.Sequence.store(Index + 1, std::memory_order_release);
+}
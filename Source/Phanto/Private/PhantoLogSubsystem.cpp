@@ -0,0 +1,66 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoLogSubsystem.h"
+
+#include "Misc/OutputDeviceRedirector.h"
+#include "PhantoLogRingBuffer.h"
+
+void UPhantoLogSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Buffer = MakeUnique<FPhantoLogRingBuffer>();
+	GLog->AddOutputDevice(Buffer.Get());
+}
+
+void UPhantoLogSubsystem::Deinitialize()
+{
+	if (Buffer)
+	{
+		GLog->RemoveOutputDevice(Buffer.Get());
+		Buffer.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+int64 UPhantoLogSubsystem::GetLogCursor() const
+{
+	return Buffer ? int64(Buffer->GetCursor()) : 0;
+}
+
+int64 UPhantoLogSubsystem::GetLinesSince(int64 Cursor, TArray<FString>& Lines, int32 MaxLines) const
+{
+	Lines.Reset();
+	if (!Buffer)
+		return Cursor;
+
+	auto const End = Buffer->GetCursor();
+	auto const Oldest = End - FMath::Min(End, uint64(FMath::Max(MaxLines, 0)));
+	auto const Start = FMath::Max(uint64(FMath::Max<int64>(Cursor, 0)), Oldest);
+	return int64(Buffer->ForEachLineSince(Start, [&Lines](const FPhantoLogLine& Line)
+	{
+		Lines.Emplace(Line.Text);
+	}));
+}
+
+int64 UPhantoLogSubsystem::AppendLinesSince(int64 Cursor, FString& Text, int32 MaxCharacters) const
+{
+	if (!Buffer)
+		return Cursor;
+
+	auto const Next = Buffer->ForEachLineSince(uint64(FMath::Max<int64>(Cursor, 0)), [&Text](const FPhantoLogLine& Line)
+	{
+		if (!Text.IsEmpty())
+			Text.AppendChar(TEXT('\n'));
+		Text.Append(Line.Text);
+	});
+
+	if (Text.Len() > MaxCharacters)
+	{
+		auto Cut = Text.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Text.Len() - MaxCharacters);
+		Text.RemoveAt(0, Cut != INDEX_NONE ? Cut + 1 : Text.Len() - MaxCharacters, EAllowShrinking::No);
+	}
+	return int64(Next);
+}
@@ -0,0 +1,160 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoNavBuildSchedulerSubsystem.h"
+
+#include "AI/NavDataGenerator.h"
+#include "Misc/App.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Phanto.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Build Tile Jobs"), STAT_PhantoNavBuildTileJobs, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Build Remaining Tiles"), STAT_PhantoNavBuildRemainingTiles, STATGROUP_Phanto);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Nav Build Overrun Frames"), STAT_PhantoNavBuildOverrunFrames, STATGROUP_Phanto);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Nav Build Budget (ms)"), STAT_PhantoNavBuildBudget, STATGROUP_Phanto);
+
+void UPhantoNavBuildSchedulerSubsystem::BeginCriticalSection(FName Reason)
+{
+	auto const bWasPaused = IsPaused();
+	++CriticalSections.FindOrAdd(Reason);
+	if (!bWasPaused)
+		ApplyPause(true);
+}
+
+void UPhantoNavBuildSchedulerSubsystem::EndCriticalSection(FName Reason)
+{
+	auto Count = CriticalSections.Find(Reason);
+	if (!Count)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("EndCriticalSection: no navigation critical section open for %s"), *Reason.ToString());
+		return;
+	}
+
+	if (--*Count == 0)
+	{
+		CriticalSections.Remove(Reason);
+		if (!IsPaused())
+			ApplyPause(false);
+	}
+}
+
+bool UPhantoNavBuildSchedulerSubsystem::IsBuilding() const
+{
+	auto NavMesh = GetNavMesh();
+	auto Generator = NavMesh ? NavMesh->GetGenerator() : nullptr;
+	return Generator && Generator->IsBuildInProgressCheckDirty();
+}
+
+float UPhantoNavBuildSchedulerSubsystem::GetBuildProgress() const
+{
+	if (PeakRemainingTiles == 0)
+		return 1;
+	return 1 - float(Stats.RemainingTiles) / PeakRemainingTiles;
+}
+
+void UPhantoNavBuildSchedulerSubsystem::ResetStats()
+{
+	Stats = FPhantoNavBuildStats();
+}
+
+void UPhantoNavBuildSchedulerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	auto NavMesh = GetNavMesh();
+	auto Generator = NavMesh ? NavMesh->GetGenerator() : nullptr;
+	if (!Generator)
+		return;
+
+	Stats.RemainingTiles = Generator->GetNumRemaningBuildTasks();
+	Stats.TileJobs = NavMesh->GetMaxSimultaneousTileGenerationJobsCount();
+	SET_DWORD_STAT(STAT_PhantoNavBuildRemainingTiles, Stats.RemainingTiles);
+	SET_DWORD_STAT(STAT_PhantoNavBuildTileJobs, Stats.TileJobs);
+
+	if (Stats.RemainingTiles == 0)
+	{
+		PeakRemainingTiles = 0;
+		return;
+	}
+
+	PeakRemainingTiles = FMath::Max(PeakRemainingTiles, Stats.RemainingTiles);
+	if (IsPaused())
+		return;
+
+	// Real frame time rather than DeltaTime, which is clamped and dilated.
+	auto const FrameMs = float(FApp::GetDeltaTime() * 1000.0);
+	++Stats.BuildFrames;
+	Stats.WorstBuildFrameMs = FMath::Max(Stats.WorstBuildFrameMs, FrameMs);
+	Stats.AverageBuildFrameMs = Stats.BuildFrames == 1 ? FrameMs : FMath::Lerp(Stats.AverageBuildFrameMs, FrameMs, 0.1f);
+	Stats.BudgetMs = FMath::Max(0.f, TargetFrameTimeMs - Stats.AverageBuildFrameMs);
+	SET_FLOAT_STAT(STAT_PhantoNavBuildBudget, Stats.BudgetMs);
+
+	// Back off quickly when over budget, grow back slowly while there is headroom.
+	auto TileJobs = Stats.TileJobs;
+	if (FrameMs > TargetFrameTimeMs)
+	{
+		++Stats.OverrunFrames;
+		INC_DWORD_STAT(STAT_PhantoNavBuildOverrunFrames);
+		TileJobs = FMath::Max(1, TileJobs / 2);
+	}
+	else if (Stats.BudgetMs > TargetFrameTimeMs * 0.15f)
+	{
+		TileJobs = FMath::Min(MaxTileJobs, TileJobs + 1);
+	}
+
+	if (TileJobs != Stats.TileJobs)
+	{
+		NavMesh->SetMaxSimultaneousTileGenerationJobsCount(TileJobs);
+		Stats.TileJobs = TileJobs;
+	}
+}
+
+TStatId UPhantoNavBuildSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPhantoNavBuildSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+bool UPhantoNavBuildSchedulerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ARecastNavMesh* UPhantoNavBuildSchedulerSubsystem::GetNavMesh() const
+{
+	auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	return NavSystem ? Cast<ARecastNavMesh>(NavSystem->GetDefaultNavDataInstance()) : nullptr;
+}
+
+void UPhantoNavBuildSchedulerSubsystem::ApplyPause(bool bPause)
+{
+	auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSystem)
+		return;
+
+	// The build lock keeps new dirty areas queued in the navigation system and the suspended navmesh doesn't start
+	// the tiles already queued in its generator; tiles being generated finish, one at a time.
+	if (bPause)
+	{
+		NavSystem->AddNavigationBuildLock(UNavigationSystemV1::ENavigationBuildLock::Custom);
+		if (auto NavMesh = GetNavMesh())
+		{
+			PausedNavMesh = NavMesh;
+			TileJobsBeforePause = NavMesh->GetMaxSimultaneousTileGenerationJobsCount();
+			NavMesh->SetRebuildingSuspended(true);
+			NavMesh->SetMaxSimultaneousTileGenerationJobsCount(1);
+		}
+	}
+	else
+	{
+		if (auto NavMesh = PausedNavMesh.Get())
+		{
+			NavMesh->SetMaxSimultaneousTileGenerationJobsCount(TileJobsBeforePause);
+			NavMesh->SetRebuildingSuspended(false);
+		}
+		PausedNavMesh.Reset();
+		NavSystem->RemoveNavigationBuildLock(UNavigationSystemV1::ENavigationBuildLock::Custom, ELockRemovalRebuildAction::NoRebuild);
+	}
+
+	UE_LOG(LogPhanto, Verbose, TEXT("Navigation building %s"), bPause ? TEXT("paused") : TEXT("resumed"));
+}
@@ -0,0 +1,369 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoNavLinkGeneratorComponent.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "NavLinkCustomComponent.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Phanto.h"
+#include "PhantoBlueprintFunctionLibrary.h"
+
+DECLARE_CYCLE_STAT(TEXT("Extract Ledge Samples"), STAT_PhantoExtractLedgeSamples, STATGROUP_Phanto);
+DECLARE_CYCLE_STAT(TEXT("Pair Ledge Samples"), STAT_PhantoPairLedgeSamples, STATGROUP_Phanto);
+
+void UPhantoNavLinkGeneratorComponent::GenerateLinks()
+{
+	if (bGenerating || bWaitingForNavigation)
+		return;
+
+	auto NavSystem = UNavigationSystemV1::GetNavigationSystem(this);
+	auto NavMesh = NavSystem ? Cast<ARecastNavMesh>(NavSystem->GetDefaultNavDataInstance()) : nullptr;
+	if (!NavMesh)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("%s: no recast navmesh to generate links on"), *GetName());
+		return;
+	}
+
+	// The tiles are read on worker threads below, which is only safe while the build isn't replacing them.
+	if (NavSystem->IsNavigationBuildInProgress())
+	{
+		bWaitingForNavigation = true;
+		NavSystem->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UPhantoNavLinkGeneratorComponent::HandleNavigationGenerationFinished);
+		return;
+	}
+
+	bGenerating = true;
+	GenerationStartTime = FPlatformTime::Seconds();
+
+	TArray<FLedgeSample> Samples;
+	ExtractLedgeSamples(*NavMesh, Samples);
+	PairLedgeSamples(*NavMesh, Samples);
+	TraceArcs();
+}
+
+void UPhantoNavLinkGeneratorComponent::ClearLinks()
+{
+	ReleaseLinks(0);
+}
+
+TArray<UNavLinkCustomComponent*> UPhantoNavLinkGeneratorComponent::GetLinks() const
+{
+	TArray<UNavLinkCustomComponent*> ActiveLinks;
+	ActiveLinks.Reserve(NumActiveLinks);
+	for (int32 Index = 0; Index < NumActiveLinks; ++Index)
+	{
+		ActiveLinks.Add(Links[Index]);
+	}
+	return ActiveLinks;
+}
+
+void UPhantoNavLinkGeneratorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	bGenerating = false;
+
+	if (bWaitingForNavigation)
+	{
+		bWaitingForNavigation = false;
+		if (auto NavSystem = UNavigationSystemV1::GetNavigationSystem(this))
+			NavSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UPhantoNavLinkGeneratorComponent::HandleNavigationGenerationFinished);
+	}
+
+	for (auto Link : Links)
+	{
+		if (Link && LinkProxyClass && Link->GetOwner() != GetOwner())
+			Link->GetOwner()->Destroy();
+	}
+	Links.Reset();
+	NumActiveLinks = 0;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UPhantoNavLinkGeneratorComponent::HandleNavigationGenerationFinished(ANavigationData* NavData)
+{
+	auto NavSystem = UNavigationSystemV1::GetNavigationSystem(this);
+	if (!NavSystem || NavData != NavSystem->GetDefaultNavDataInstance())
+		return;
+
+	NavSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UPhantoNavLinkGeneratorComponent::HandleNavigationGenerationFinished);
+	bWaitingForNavigation = false;
+
+	// Waits again if more tiles were dirtied in the meantime.
+	GenerateLinks();
+}
+
+void UPhantoNavLinkGeneratorComponent::ExtractLedgeSamples(const ARecastNavMesh& NavMesh, TArray<FLedgeSample>& OutSamples) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoExtractLedgeSamples);
+
+	auto const NumTiles = NavMesh.GetNavMeshTilesCount();
+	auto const ProbeExtent = FVector(LedgeProbeDistance * 0.5f, LedgeProbeDistance * 0.5f, MinDropHeight * 0.5f);
+
+	TArray<TArray<FLedgeSample>> TileSamples;
+	TileSamples.SetNum(NumTiles);
+
+	// Navmesh queries are read only, so tiles can be processed on worker threads as long as no build is running.
+	ParallelFor(NumTiles, [&](int32 TileIndex)
+	{
+		FRecastDebugGeometry Geometry;
+		Geometry.bGatherNavMeshEdges = true;
+		NavMesh.GetDebugGeometryForTile(Geometry, TileIndex);
+
+		auto& Samples = TileSamples[TileIndex];
+		for (int32 i = 0; i + 1 < Geometry.NavMeshEdges.Num(); i += 2)
+		{
+			auto const A = Geometry.NavMeshEdges[i];
+			auto const B = Geometry.NavMeshEdges[i + 1];
+			auto const Length = FVector::Dist2D(A, B);
+			if (Length < KINDA_SMALL_NUMBER)
+				continue;
+
+			// Boundary edges don't tell which side the polygon is on, so probe the navmesh on one side.
+			auto const Direction = (B - A).GetSafeNormal2D();
+			auto Outward = FVector(Direction.Y, -Direction.X, 0);
+			auto const Middle = (A + B) * 0.5;
+			FNavLocation Projected;
+			if (NavMesh.ProjectPoint(Middle + Outward * LedgeProbeDistance, Projected, ProbeExtent))
+				Outward = -Outward;
+
+			auto const Count = FMath::Max(1, FMath::FloorToInt(Length / EdgeSampleSpacing));
+			for (int32 j = 0; j < Count; ++j)
+			{
+				Samples.Add({ FMath::Lerp(A, B, (j + 0.5) / Count), Outward });
+			}
+		}
+	});
+
+	for (auto& Samples : TileSamples)
+	{
+		OutSamples.Append(MoveTemp(Samples));
+	}
+}
+
+void UPhantoNavLinkGeneratorComponent::PairLedgeSamples(const ARecastNavMesh& NavMesh, TConstArrayView<FLedgeSample> Samples)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoPairLedgeSamples);
+
+	// 2D spatial hash with cells as large as the search radius, so only the 3x3 neighborhood needs checking.
+	auto const CellSize = FMath::Max(MaxHorizontalDistance, 1.f);
+	auto CellOf = [CellSize](const FVector& Location)
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+	};
+
+	TMap<FIntPoint, TArray<int32>> SpatialHash;
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		SpatialHash.FindOrAdd(CellOf(Samples[i].Location)).Add(i);
+	}
+
+	auto const LandingExtent = FVector(LedgeProbeDistance, LedgeProbeDistance, MinDropHeight * 0.5f);
+	auto const MaxDistanceSquared = FMath::Square(MaxHorizontalDistance);
+
+	Candidates.Reset();
+	Candidates.SetNum(Samples.Num());
+
+	ParallelFor(Samples.Num(), [&](int32 Index)
+	{
+		auto const& Top = Samples[Index];
+		auto const Cell = CellOf(Top.Location);
+
+		int32 Best = INDEX_NONE;
+		double BestDistanceSquared = MaxDistanceSquared;
+		for (int32 Y = -1; Y <= 1; ++Y)
+		{
+			for (int32 X = -1; X <= 1; ++X)
+			{
+				auto Bucket = SpatialHash.Find(Cell + FIntPoint(X, Y));
+				if (!Bucket)
+					continue;
+
+				for (auto const Other : *Bucket)
+				{
+					auto const Offset = Samples[Other].Location - Top.Location;
+					auto const Drop = -Offset.Z;
+					if (Drop < MinDropHeight || Drop > MaxDropHeight)
+						continue;
+
+					// The landing has to be in front of the ledge, within a 60 degree cone.
+					auto const DistanceSquared = Offset.SizeSquared2D();
+					auto const Forward = Offset.X * Top.Outward.X + Offset.Y * Top.Outward.Y;
+					if (Forward <= 0 || FMath::Square(Forward) < DistanceSquared * 0.25 || DistanceSquared >= BestDistanceSquared)
+						continue;
+
+					Best = Other;
+					BestDistanceSquared = DistanceSquared;
+				}
+			}
+		}
+
+		if (Best == INDEX_NONE)
+			return;
+
+		// Land a bit away from the base of the furniture, on the navmesh.
+		FNavLocation Landing;
+		if (!NavMesh.ProjectPoint(Samples[Best].Location + Top.Outward * LedgeProbeDistance, Landing, LandingExtent))
+			return;
+
+		auto& Candidate = Candidates[Index];
+		Candidate.Top = Top.Location;
+		Candidate.Bottom = Landing.Location;
+		Candidate.bValid = true;
+	});
+
+	Candidates.RemoveAllSwap([](const FLinkCandidate& Candidate) { return !Candidate.bValid; });
+}
+
+void UPhantoNavLinkGeneratorComponent::TraceArcs()
+{
+	auto World = GetWorld();
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(PhantoNavLinkArc), false, GetOwner());
+	auto const Delegate = FTraceDelegate::CreateUObject(this, &UPhantoNavLinkGeneratorComponent::OnArcTraced);
+	auto const Up = FVector(0, 0, ArcTraceHeightOffset);
+
+	// All the traces of the frame are batched by the engine and run in parallel on worker threads;
+	// their results come back through OnArcTraced next frame.
+	PendingTraces = Candidates.Num() * ArcSegments;
+	for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+	{
+		auto const& Candidate = Candidates[Index];
+		auto ArcPoint = [&](int32 Segment)
+		{
+			auto const Alpha = double(Segment) / ArcSegments;
+			return FMath::Lerp(Candidate.Top, Candidate.Bottom, Alpha) + Up + FVector(0, 0, 4 * ArcHeight * Alpha * (1 - Alpha));
+		};
+
+		for (int32 Segment = 0; Segment < ArcSegments; ++Segment)
+		{
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, ArcPoint(Segment), ArcPoint(Segment + 1), TraceChannel,
+				Params, FCollisionResponseParams::DefaultResponseParam, &Delegate, Index);
+		}
+	}
+
+	if (PendingTraces == 0)
+		FinishGeneration();
+}
+
+void UPhantoNavLinkGeneratorComponent::OnArcTraced(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	if (!bGenerating)
+		return;
+
+	if (Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit && Candidates.IsValidIndex(Datum.UserData))
+		Candidates[Datum.UserData].bValid = false;
+
+	if (--PendingTraces == 0)
+		FinishGeneration();
+}
+
+void UPhantoNavLinkGeneratorComponent::OptimizeCandidates()
+{
+	TArray<FPhantoNavLinkSetOptimizer::FLink> OptimizerLinks;
+	OptimizerLinks.Reserve(Candidates.Num());
+	for (auto const& Candidate : Candidates)
+	{
+		OptimizerLinks.Add({ Candidate.Top, Candidate.Bottom, LinkDirection });
+	}
+
+	TArray<int32> MergedInto;
+	auto const NumBefore = Candidates.Num();
+	auto const NumAfter = FPhantoNavLinkSetOptimizer::Optimize(OptimizerLinks, MergeSettings, MergedInto);
+
+	for (int32 i = 0; i < Candidates.Num(); ++i)
+	{
+		Candidates[i].Top = OptimizerLinks[i].Start;
+		Candidates[i].Bottom = OptimizerLinks[i].End;
+		Candidates[i].bValid = MergedInto[i] == i;
+	}
+	Candidates.RemoveAll([](const FLinkCandidate& Candidate) { return !Candidate.bValid; });
+
+	UE_LOG(LogPhanto, Verbose, TEXT("%s: merged %d nav link candidates into %d"), *GetName(), NumBefore, NumAfter);
+}
+
+void UPhantoNavLinkGeneratorComponent::FinishGeneration()
+{
+	Candidates.RemoveAllSwap([](const FLinkCandidate& Candidate) { return !Candidate.bValid; });
+
+	if (bOptimizeLinks)
+		OptimizeCandidates();
+
+	TArray<UNavLinkCustomComponent*> BatchLinks;
+	TArray<FVector> RelativeStarts, RelativeEnds;
+	TArray<TEnumAsByte<ENavLinkDirection::Type>> Directions;
+	BatchLinks.Reserve(Candidates.Num());
+	RelativeStarts.Reserve(Candidates.Num());
+	RelativeEnds.Reserve(Candidates.Num());
+	Directions.Init(LinkDirection, Candidates.Num());
+
+	for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+	{
+		auto const& Candidate = Candidates[Index];
+		auto Link = AcquireLink(Index, Candidate.Top);
+		auto const& LinkTransform = Link->GetOwner()->GetActorTransform();
+		BatchLinks.Add(Link);
+		RelativeStarts.Add(LinkTransform.InverseTransformPosition(Candidate.Top));
+		RelativeEnds.Add(LinkTransform.InverseTransformPosition(Candidate.Bottom));
+	}
+
+	ReleaseLinks(Candidates.Num());
+	NumActiveLinks = Candidates.Num();
+	UPhantoBlueprintFunctionLibrary::SetLinkDataBatch(BatchLinks, RelativeStarts, RelativeEnds, Directions);
+
+	Candidates.Empty();
+	bGenerating = false;
+
+	auto const DurationMs = float((FPlatformTime::Seconds() - GenerationStartTime) * 1000.0);
+	UE_LOG(LogPhanto, Log, TEXT("%s: generated %d nav links in %.2f ms"), *GetName(), NumActiveLinks, DurationMs);
+	OnLinksGenerated.Broadcast(NumActiveLinks, DurationMs);
+}
+
+UNavLinkCustomComponent* UPhantoNavLinkGeneratorComponent::AcquireLink(int32 Index, const FVector& Location)
+{
+	if (Links.IsValidIndex(Index) && Links[Index])
+	{
+		auto Link = Links[Index].Get();
+		if (Link->GetOwner() != GetOwner())
+			Link->GetOwner()->SetActorLocation(Location);
+		return Link;
+	}
+
+	UNavLinkCustomComponent* Link = nullptr;
+	if (LinkProxyClass)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Owner = GetOwner();
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		if (auto Proxy = GetWorld()->SpawnActor<AActor>(LinkProxyClass, Location, FRotator::ZeroRotator, SpawnParameters))
+			Link = Proxy->FindComponentByClass<UNavLinkCustomComponent>();
+	}
+
+	if (!Link)
+	{
+		Link = NewObject<UNavLinkCustomComponent>(GetOwner());
+		Link->RegisterComponent();
+	}
+
+	if (Links.Num() <= Index)
+		Links.SetNum(Index + 1);
+	Links[Index] = Link;
+	return Link;
+}
+
+void UPhantoNavLinkGeneratorComponent::ReleaseLinks(int32 FirstIndex)
+{
+	auto NavSystem = UNavigationSystemV1::GetNavigationSystem(this);
+	for (int32 Index = FirstIndex; Index < NumActiveLinks && Index < Links.Num(); ++Index)
+	{
+		if (auto Link = Links[Index].Get())
+		{
+			if (NavSystem)
+				NavSystem->UnregisterCustomLink(*Link);
+			Link->SetNavigationRelevancy(false);
+		}
+	}
+	NumActiveLinks = FMath::Min(NumActiveLinks, FirstIndex);
+}
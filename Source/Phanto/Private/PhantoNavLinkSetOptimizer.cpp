@@ -0,0 +1,88 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoNavLinkSetOptimizer.h"
+
+int32 FPhantoNavLinkSetOptimizer::Optimize(TArray<FLink>& Links, const FPhantoNavLinkMergeSettings& Settings, TArray<int32>& OutMergedInto)
+{
+	OutMergedInto.Init(INDEX_NONE, Links.Num());
+
+	auto const Tolerance = FMath::Max(Settings.EndpointTolerance, KINDA_SMALL_NUMBER);
+	auto const ToleranceSquared = FMath::Square(Tolerance);
+	auto const MinCosAngle = FMath::Cos(FMath::DegreesToRadians(Settings.MaxAngleDegrees));
+
+	auto CellOf = [Tolerance](const FVector& Location)
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / Tolerance),
+			FMath::FloorToInt(Location.Y / Tolerance),
+			FMath::FloorToInt(Location.Z / Tolerance));
+	};
+
+	TMap<FIntVector, TArray<int32>> Grid;
+	Grid.Reserve(Links.Num());
+	TArray<FVector> Directions;
+	Directions.Reserve(Links.Num());
+	for (int32 i = 0; i < Links.Num(); ++i)
+	{
+		Grid.FindOrAdd(CellOf(Links[i].Start)).Add(i);
+		Directions.Add((Links[i].End - Links[i].Start).GetSafeNormal());
+	}
+
+	int32 NumKept = 0;
+	TArray<int32> Cluster;
+	for (int32 i = 0; i < Links.Num(); ++i)
+	{
+		if (OutMergedInto[i] != INDEX_NONE)
+			continue;
+
+		OutMergedInto[i] = i;
+		++NumKept;
+
+		auto const& Link = Links[i];
+		auto const Cell = CellOf(Link.Start);
+
+		Cluster.Reset();
+		for (int32 Z = -1; Z <= 1; ++Z)
+		{
+			for (int32 Y = -1; Y <= 1; ++Y)
+			{
+				for (int32 X = -1; X <= 1; ++X)
+				{
+					auto Bucket = Grid.Find(Cell + FIntVector(X, Y, Z));
+					if (!Bucket)
+						continue;
+
+					for (auto const Other : *Bucket)
+					{
+						if (OutMergedInto[Other] != INDEX_NONE || Links[Other].Direction != Link.Direction)
+							continue;
+
+						if (FVector::DistSquared(Links[Other].Start, Link.Start) > ToleranceSquared
+							|| FVector::DistSquared(Links[Other].End, Link.End) > ToleranceSquared
+							|| FVector::DotProduct(Directions[Other], Directions[i]) < MinCosAngle)
+							continue;
+
+						OutMergedInto[Other] = i;
+						Cluster.Add(Other);
+					}
+				}
+			}
+		}
+
+		if (Settings.bAverageMergedLinks && Cluster.Num() > 0)
+		{
+			auto Start = Link.Start;
+			auto End = Link.End;
+			for (auto const Other : Cluster)
+			{
+				Start += Links[Other].Start;
+				End += Links[Other].End;
+			}
+			Links[i].Start = Start / (Cluster.Num() + 1);
+			Links[i].End = End / (Cluster.Num() + 1);
+		}
+	}
+
+	return NumKept;
+}
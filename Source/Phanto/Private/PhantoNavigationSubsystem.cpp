@@ -0,0 +1,145 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoNavigationSubsystem.h"
+
+#include "AI/NavDataGenerator.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "Phanto.h"
+#include "UObject/UnrealType.h"
+
+void UPhantoNavigationSubsystem::OpenBuildWindow(FName Reason)
+{
+	++OpenWindows.FindOrAdd(Reason);
+
+	// A window opening while the previous build is still running just extends it: the new dirty areas are
+	// collected and rebuilt together with whatever is left.
+	if (State != EState::Collecting)
+		BeginCollecting();
+}
+
+void UPhantoNavigationSubsystem::CloseBuildWindow(FName Reason)
+{
+	auto Count = OpenWindows.Find(Reason);
+	if (!Count)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("CloseBuildWindow: no navigation build window open for %s"), *Reason.ToString());
+		return;
+	}
+
+	if (--*Count == 0)
+	{
+		OpenWindows.Remove(Reason);
+		if (OpenWindows.Num() == 0)
+			BeginBuild();
+	}
+}
+
+void UPhantoNavigationSubsystem::AddDirtyBounds(const FBox& Bounds)
+{
+	if (Bounds.IsValid)
+		DirtyBounds.Add(Bounds);
+}
+
+void UPhantoNavigationSubsystem::SetRuntimeGenerationMode(ANavigationData& NavData, ERuntimeGenerationType Mode)
+{
+	// RuntimeGeneration is a protected UPROPERTY without a setter, go through reflection rather than poking the memory.
+	static auto const Property = CastField<FEnumProperty>(ANavigationData::StaticClass()->FindPropertyByName(TEXT("RuntimeGeneration")));
+	if (!ensureMsgf(Property, TEXT("ANavigationData::RuntimeGeneration not found")))
+		return;
+
+	Property->GetUnderlyingProperty()->SetIntPropertyValue(Property->ContainerPtrToValuePtr<void>(&NavData), int64(Mode));
+
+	if (auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(NavData.GetWorld()))
+		NavSystem->SetNavigationOctreeLock(Mode != ERuntimeGenerationType::Dynamic);
+}
+
+void UPhantoNavigationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (State != EState::Building)
+		return;
+
+	auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	auto NavData = NavSystem ? NavSystem->GetDefaultNavDataInstance() : nullptr;
+	auto Generator = NavData ? NavData->GetGenerator() : nullptr;
+	if (!Generator)
+	{
+		FinishBuild();
+		return;
+	}
+
+	// Dirty areas still queued in the navigation system haven't reached the generator yet.
+	if (!Generator->IsBuildInProgressCheckDirty() && !NavSystem->HasDirtyAreasQueued())
+		FinishBuild();
+}
+
+TStatId UPhantoNavigationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPhantoNavigationSubsystem, STATGROUP_Tickables);
+}
+
+bool UPhantoNavigationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ANavigationData* UPhantoNavigationSubsystem::GetNavData() const
+{
+	auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	return NavSystem ? NavSystem->GetDefaultNavDataInstance() : nullptr;
+}
+
+void UPhantoNavigationSubsystem::BeginCollecting()
+{
+	auto NavData = GetNavData();
+	if (!NavData)
+		return;
+
+	if (State == EState::Static)
+		WindowStartTime = FPlatformTime::Seconds();
+	State = EState::Collecting;
+
+	// Suspended nav data keeps the dirty areas it receives until rebuilding is resumed.
+	SetRuntimeGenerationMode(*NavData, ERuntimeGenerationType::Dynamic);
+	NavData->SetRebuildingSuspended(true);
+}
+
+void UPhantoNavigationSubsystem::BeginBuild()
+{
+	auto NavData = GetNavData();
+	if (!NavData || State != EState::Collecting)
+		return;
+
+	State = EState::Building;
+	BuildStartTime = FPlatformTime::Seconds();
+
+	TArray<FNavigationDirtyArea> DirtyAreas;
+	DirtyAreas.Reserve(DirtyBounds.Num());
+	for (auto const& Bounds : DirtyBounds)
+	{
+		DirtyAreas.Emplace(Bounds, ENavigationDirtyFlag::All);
+	}
+	DirtyBounds.Reset();
+
+	NavData->SetRebuildingSuspended(false);
+	if (DirtyAreas.Num() > 0)
+		NavData->RebuildDirtyAreas(DirtyAreas);
+}
+
+void UPhantoNavigationSubsystem::FinishBuild()
+{
+	auto const Now = FPlatformTime::Seconds();
+	auto const WindowMs = float((Now - WindowStartTime) * 1000.0);
+	LastBuildMs = float((Now - BuildStartTime) * 1000.0);
+	TotalDynamicMs += WindowMs;
+	State = EState::Static;
+
+	if (auto NavData = GetNavData())
+		SetRuntimeGenerationMode(*NavData, ERuntimeGenerationType::Static);
+
+	UE_LOG(LogPhanto, Log, TEXT("Navigation build window closed after %.2f ms, consolidated build took %.2f ms"), WindowMs, LastBuildMs);
+	OnBuildWindowClosed.Broadcast(WindowMs, LastBuildMs);
+}
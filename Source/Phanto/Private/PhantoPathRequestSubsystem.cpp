@@ -0,0 +1,265 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoPathRequestSubsystem.h"
+
+#include "AIController.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "NavigationSystem.h"
+#include "NavMesh/NavMeshPath.h"
+#include "Phanto.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Request Queue Depth"), STAT_PhantoPathRequestQueueDepth, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Requests In Flight"), STAT_PhantoPathRequestsInFlight, STATGROUP_Phanto);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Request Cache Hits"), STAT_PhantoPathRequestCacheHits, STATGROUP_Phanto);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Path Request Latency (ms)"), STAT_PhantoPathRequestLatency, STATGROUP_Phanto);
+
+uint32 UPhantoPathRequestSubsystem::RequestPath(const FNavAgentProperties& AgentProperties, const FVector& Start, const FVector& End, const UObject* Querier, FPhantoPathRequestDelegate Callback)
+{
+	auto const Id = NextRequestId++;
+	if (NextRequestId == 0)
+		NextRequestId = 1;
+
+	Pending.Add({ Id, AgentProperties, Start, End, Querier, MoveTemp(Callback), FPlatformTime::Seconds() });
+	Stats.QueueDepth = Pending.Num();
+	Stats.PeakQueueDepth = FMath::Max(Stats.PeakQueueDepth, Stats.QueueDepth);
+	return Id;
+}
+
+void UPhantoPathRequestSubsystem::CancelRequest(uint32 RequestId)
+{
+	if (Pending.RemoveAll([RequestId](const FRequest& Request) { return Request.Id == RequestId; }) > 0)
+	{
+		Stats.QueueDepth = Pending.Num();
+		return;
+	}
+
+	for (auto It = InFlight.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Id != RequestId)
+			continue;
+
+		if (auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld()))
+			NavSystem->AbortAsyncFindPathRequest(It.Key());
+		It.RemoveCurrent();
+		Stats.InFlight = InFlight.Num();
+		return;
+	}
+
+	// Cancelled from a callback while Tick works on its detached queue.
+	if (bDispatching)
+		CancelledIds.Add(RequestId);
+}
+
+void UPhantoPathRequestSubsystem::ResetStats()
+{
+	Stats = FPhantoPathRequestStats();
+	Stats.QueueDepth = Pending.Num();
+	Stats.InFlight = InFlight.Num();
+}
+
+void UPhantoPathRequestSubsystem::ClearCache()
+{
+	Cache.Reset();
+}
+
+void UPhantoPathRequestSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Cache.Num() > MaxCacheEntries)
+	{
+		auto const Now = FPlatformTime::Seconds();
+		for (auto It = Cache.CreateIterator(); It; ++It)
+		{
+			if (Now - It.Value().Time > CacheLifetime)
+				It.RemoveCurrent();
+		}
+	}
+
+	// Counter stats are cleared every frame, set them even when there is nothing to dispatch.
+	SET_DWORD_STAT(STAT_PhantoPathRequestQueueDepth, Pending.Num());
+	SET_DWORD_STAT(STAT_PhantoPathRequestsInFlight, InFlight.Num());
+
+	auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSystem || Pending.Num() == 0)
+		return;
+
+	// Callbacks can queue new requests, work on a detached queue.
+	auto Requests = MoveTemp(Pending);
+	Pending.Reset();
+	bDispatching = true;
+
+	int32 NumDispatched = 0;
+	int32 Index = 0;
+	for (; Index < Requests.Num(); ++Index)
+	{
+		auto& Request = Requests[Index];
+		if (CancelledIds.Remove(Request.Id) > 0)
+			continue;
+
+		auto NavData = NavSystem->GetNavDataForProps(Request.AgentProperties, Request.Start);
+		if (!NavData)
+		{
+			Complete(Request, nullptr);
+			continue;
+		}
+
+		Request.NavData = NavData;
+		Request.FilterClass = GetFilterClass(Request.Querier.Get());
+		if (TryCompleteFromCache(Request, *NavData))
+			continue;
+
+		if (NumDispatched >= MaxDispatchesPerFrame || InFlight.Num() >= MaxInFlight)
+			break;
+
+		auto Querier = Request.Querier.Get();
+		FPathFindingQuery Query(Querier, *NavData, Request.Start, Request.End, UNavigationQueryFilter::GetQueryFilter(*NavData, Querier, Request.FilterClass));
+		auto const QueryId = NavSystem->FindPathAsync(Request.AgentProperties, Query,
+			FNavPathQueryDelegate::CreateUObject(this, &UPhantoPathRequestSubsystem::HandlePathFound));
+		if (QueryId == INVALID_NAVQUERYID)
+		{
+			Complete(Request, nullptr);
+			continue;
+		}
+
+		InFlight.Add(QueryId, MoveTemp(Request));
+		++NumDispatched;
+	}
+	Requests.RemoveAt(0, Index, EAllowShrinking::No);
+	if (CancelledIds.Num() > 0)
+		Requests.RemoveAll([this](const FRequest& Request) { return CancelledIds.Contains(Request.Id); });
+	CancelledIds.Reset();
+	bDispatching = false;
+
+	Requests.Append(MoveTemp(Pending));
+	Pending = MoveTemp(Requests);
+
+	Stats.QueueDepth = Pending.Num();
+	Stats.InFlight = InFlight.Num();
+	SET_DWORD_STAT(STAT_PhantoPathRequestQueueDepth, Stats.QueueDepth);
+	SET_DWORD_STAT(STAT_PhantoPathRequestsInFlight, Stats.InFlight);
+}
+
+TStatId UPhantoPathRequestSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPhantoPathRequestSubsystem, STATGROUP_Tickables);
+}
+
+bool UPhantoPathRequestSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPhantoPathRequestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(&InWorld))
+		NavSystem->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UPhantoPathRequestSubsystem::HandleNavigationGenerationFinished);
+}
+
+void UPhantoPathRequestSubsystem::Deinitialize()
+{
+	if (auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		NavSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UPhantoPathRequestSubsystem::HandleNavigationGenerationFinished);
+		for (auto const& Request : InFlight)
+		{
+			NavSystem->AbortAsyncFindPathRequest(Request.Key);
+		}
+	}
+	InFlight.Reset();
+	Pending.Reset();
+
+	Super::Deinitialize();
+}
+
+UPhantoPathRequestSubsystem::FCacheKey UPhantoPathRequestSubsystem::GetCacheKey(const FRequest& Request) const
+{
+	auto CellOf = [this](const FVector& Location)
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / CacheCellSize),
+			FMath::FloorToInt(Location.Y / CacheCellSize),
+			FMath::FloorToInt(Location.Z / CacheCellSize));
+	};
+	return FCacheKey(Request.NavData, Request.FilterClass.Get(), CellOf(Request.Start), CellOf(Request.End));
+}
+
+bool UPhantoPathRequestSubsystem::TryCompleteFromCache(FRequest& Request, ANavigationData& NavData)
+{
+	if (CacheCellSize <= 0)
+		return false;
+
+	auto const Key = GetCacheKey(Request);
+	auto Entry = Cache.Find(Key);
+	if (!Entry)
+		return false;
+
+	if (FPlatformTime::Seconds() - Entry->Time > CacheLifetime)
+	{
+		Cache.Remove(Key);
+		return false;
+	}
+
+	// Each requester gets its own path, path following keeps per path state.
+	auto Path = MakeShared<FNavMeshPath>();
+	auto& Points = Path->GetPathPoints();
+	Points = Entry->Points;
+
+	// The cached ends can be up to a cell away from the requested ones; keep the cached path as found and connect the
+	// requested ends to it, moving its ends would change the first and last segments.
+	if (!Points[0].Location.Equals(Request.Start))
+		Points.Insert(FNavPathPoint(Request.Start, Points[0].NodeRef), 0);
+	if (!Points.Last().Location.Equals(Request.End))
+		Points.Add(FNavPathPoint(Request.End, Points.Last().NodeRef));
+	Path->SetNavigationDataUsed(&NavData);
+	Path->SetQuerier(Request.Querier.Get());
+	Path->MarkReady();
+
+	++Stats.CacheHits;
+	INC_DWORD_STAT(STAT_PhantoPathRequestCacheHits);
+	Complete(Request, Path);
+	return true;
+}
+
+TSubclassOf<UNavigationQueryFilter> UPhantoPathRequestSubsystem::GetFilterClass(const UObject* Querier)
+{
+	auto Controller = Cast<AAIController>(Querier);
+	if (auto Pawn = Cast<APawn>(Querier))
+		Controller = Cast<AAIController>(Pawn->GetController());
+
+	return Controller ? Controller->GetDefaultNavigationFilterClass() : nullptr;
+}
+
+void UPhantoPathRequestSubsystem::Complete(FRequest& Request, FNavPathSharedPtr Path)
+{
+	auto const LatencyMs = float((FPlatformTime::Seconds() - Request.RequestTime) * 1000.0);
+	++Stats.Completed;
+	Stats.AverageLatencyMs = Stats.Completed == 1 ? LatencyMs : FMath::Lerp(Stats.AverageLatencyMs, LatencyMs, 0.1f);
+	Stats.WorstLatencyMs = FMath::Max(Stats.WorstLatencyMs, LatencyMs);
+	SET_FLOAT_STAT(STAT_PhantoPathRequestLatency, Stats.AverageLatencyMs);
+
+	Request.Callback.ExecuteIfBound(Request.Id, Path);
+}
+
+void UPhantoPathRequestSubsystem::HandlePathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	FRequest Request;
+	if (!InFlight.RemoveAndCopyValue(QueryId, Request))
+		return;
+
+	Stats.InFlight = InFlight.Num();
+
+	auto const bFound = Result == ENavigationQueryResult::Success && Path.IsValid() && Path->IsValid();
+	if (bFound && !Path->IsPartial() && CacheCellSize > 0 && Path->GetPathPoints().Num() >= 2)
+		Cache.Add(GetCacheKey(Request), { Path->GetPathPoints(), FPlatformTime::Seconds() });
+
+	Complete(Request, bFound ? Path : nullptr);
+}
+
+void UPhantoPathRequestSubsystem::HandleNavigationGenerationFinished(ANavigationData* NavData)
+{
+	ClearCache();
+}
@@ -0,0 +1,181 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoProjectileManager.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "NiagaraFunctionLibrary.h"
+#include "Phanto.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectiles Update"), STAT_PhantoProjectilesUpdate, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Live Projectiles"), STAT_PhantoLiveProjectiles, STATGROUP_Phanto);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Impacts"), STAT_PhantoProjectileImpacts, STATGROUP_Phanto);
+
+APhantoProjectileManager::APhantoProjectileManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	Projectiles = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Projectiles"));
+	Projectiles->SetMobility(EComponentMobility::Movable);
+	Projectiles->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Projectiles->SetCanEverAffectNavigation(false);
+	RootComponent = Projectiles;
+}
+
+bool APhantoProjectileManager::FireProjectile(FVector Location, FVector Velocity, AActor* Instigator)
+{
+	if (Locations.Num() >= MaxLiveProjectiles)
+	{
+		++Stats.Rejected;
+		return false;
+	}
+
+	Locations.Add(Location);
+	Velocities.Add(Velocity);
+	Ages.Add(0);
+	Instigators.Add(Instigator);
+	Traces.AddDefaulted();
+
+	++Stats.Fired;
+	Stats.LiveProjectiles = Locations.Num();
+	Stats.PeakLiveProjectiles = FMath::Max(Stats.PeakLiveProjectiles, Stats.LiveProjectiles);
+	return true;
+}
+
+void APhantoProjectileManager::ClearProjectiles()
+{
+	Locations.Reset();
+	Velocities.Reset();
+	Ages.Reset();
+	Instigators.Reset();
+	Traces.Reset();
+	Stats.LiveProjectiles = 0;
+	UpdateInstances();
+}
+
+APhantoProjectileManager* APhantoProjectileManager::GetProjectileManager(const UObject* WorldContext)
+{
+	auto World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World)
+		return nullptr;
+
+	for (TActorIterator<APhantoProjectileManager> It(World); It; ++It)
+	{
+		return *It;
+	}
+	return nullptr;
+}
+
+void APhantoProjectileManager::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoProjectilesUpdate);
+	Super::Tick(DeltaSeconds);
+
+	auto World = GetWorld();
+
+	// Last frame's traces have been resolved by now, a hit ends the projectile where it touched.
+	for (auto i = Locations.Num() - 1; i >= 0; --i)
+	{
+		if (!Traces[i].IsValid())
+			continue;
+
+		FTraceDatum Datum;
+		if (!World->QueryTraceData(Traces[i], Datum))
+			continue;
+
+		Traces[i] = FTraceHandle();
+		if (auto Hit = FHitResult::GetFirstBlockingHit(Datum.OutHits))
+			HandleImpact(i, *Hit);
+	}
+
+	for (auto i = Ages.Num() - 1; i >= 0; --i)
+	{
+		Ages[i] += DeltaSeconds;
+		if (Ages[i] > MaxLifetime)
+		{
+			++Stats.Expired;
+			RemoveProjectile(i);
+		}
+	}
+
+	// Ballistic step of every projectile at once, exact for constant gravity.
+	auto const Gravity = FVector(0, 0, World->GetGravityZ() * GravityScale);
+	auto const HalfGravityStep = 0.5 * Gravity * DeltaSeconds * DeltaSeconds;
+	auto const GravityStep = Gravity * DeltaSeconds;
+
+	TArray<FVector, TInlineAllocator<64>> Previous(Locations);
+	for (auto i = 0; i < Locations.Num(); ++i)
+	{
+		Locations[i] += Velocities[i] * DeltaSeconds + HalfGravityStep;
+		Velocities[i] += GravityStep;
+	}
+
+	for (auto i = 0; i < Locations.Num(); ++i)
+	{
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(PhantoProjectile), false, Instigators[i].Get());
+		Traces[i] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Previous[i], Locations[i], TraceChannel, Params);
+	}
+
+	UpdateInstances();
+
+	SET_DWORD_STAT(STAT_PhantoLiveProjectiles, Locations.Num());
+}
+
+void APhantoProjectileManager::RemoveProjectile(int32 Index)
+{
+	Locations.RemoveAtSwap(Index, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, EAllowShrinking::No);
+	Ages.RemoveAtSwap(Index, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, EAllowShrinking::No);
+	Traces.RemoveAtSwap(Index, EAllowShrinking::No);
+	Stats.LiveProjectiles = Locations.Num();
+}
+
+void APhantoProjectileManager::HandleImpact(int32 Index, const FHitResult& Hit)
+{
+	++Stats.Impacts;
+	INC_DWORD_STAT(STAT_PhantoProjectileImpacts);
+
+	if (ImpactEffect)
+	{
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, ImpactEffect, Hit.ImpactPoint, Hit.ImpactNormal.Rotation(),
+			FVector::OneVector, true, true, ENCPoolMethod::AutoRelease);
+	}
+
+	auto Instigator = Instigators[Index].Get();
+	RemoveProjectile(Index);
+	OnProjectileImpact.Broadcast(Hit, Instigator);
+}
+
+void APhantoProjectileManager::UpdateInstances()
+{
+	auto const Scale = FVector(ProjectileScale);
+	InstanceTransforms.SetNum(Locations.Num(), EAllowShrinking::No);
+	for (auto i = 0; i < Locations.Num(); ++i)
+	{
+		InstanceTransforms[i] = FTransform(FQuat::Identity, Locations[i], Scale);
+	}
+
+	// Instances are only added or removed at the end, the live ones are rewritten in a single batch.
+	auto const NumInstances = Projectiles->GetInstanceCount();
+	if (NumInstances > Locations.Num())
+	{
+		TArray<int32> Removed;
+		for (auto i = NumInstances - 1; i >= Locations.Num(); --i)
+		{
+			Removed.Add(i);
+		}
+		Projectiles->RemoveInstances(Removed);
+	}
+	else if (NumInstances < Locations.Num())
+	{
+		TArray<FTransform> Added(&InstanceTransforms[NumInstances], Locations.Num() - NumInstances);
+		Projectiles->AddInstances(Added, false, true, false);
+	}
+
+	if (InstanceTransforms.Num() > 0)
+		Projectiles->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+}
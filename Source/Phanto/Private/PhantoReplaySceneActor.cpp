@@ -0,0 +1,116 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoReplaySceneActor.h"
+
+#include "BlueprintXRSceneAnchorComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/Paths.h"
+#include "Phanto.h"
+#include "PhantoSceneCapture.h"
+#include "ProceduralMeshComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Load Scene Capture"), STAT_PhantoLoadSceneCapture, STATGROUP_Phanto);
+
+APhantoReplaySceneActor::APhantoReplaySceneActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void APhantoReplaySceneActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bLoadOnBeginPlay && !CapturePath.IsEmpty())
+		LoadCapture(CapturePath);
+}
+
+void APhantoReplaySceneActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ClearScene();
+	Super::EndPlay(EndPlayReason);
+}
+
+bool APhantoReplaySceneActor::LoadCapture(const FString& Path)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoLoadSceneCapture);
+
+	auto const StartTime = FPlatformTime::Seconds();
+	auto const FullPath = FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectDir(), Path) : Path;
+	auto Capture = FPhantoSceneCapture::Open(FullPath);
+	if (!Capture)
+		return false;
+
+	ClearScene();
+
+	auto World = GetWorld();
+	auto const Vertices = Capture->GetVertices();
+	auto const Indices = Capture->GetIndices();
+	TArray<FVector> LocalVertices;
+	TArray<int32> Triangles;
+	for (auto const& Anchor : Capture->GetAnchors())
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Owner = this;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		auto AnchorActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		if (!AnchorActor)
+			continue;
+
+		// A bare actor has no root to place it with.
+		auto const Transform = Anchor.GetTransform();
+		auto Root = NewObject<USceneComponent>(AnchorActor, TEXT("Root"));
+		AnchorActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+		AnchorActor->SetActorTransform(Transform);
+
+		if (Anchor.NumIndices > 0)
+		{
+			LocalVertices.Reset(Anchor.NumVertices);
+			for (auto const& Vertex : Vertices.Slice(int32(Anchor.FirstVertex), int32(Anchor.NumVertices)))
+			{
+				LocalVertices.Add(Transform.InverseTransformPosition(FVector(Vertex)));
+			}
+
+			Triangles.Reset(Anchor.NumIndices);
+			for (auto Index : Indices.Slice(int32(Anchor.FirstIndex), int32(Anchor.NumIndices)))
+			{
+				Triangles.Add(int32(Index - Anchor.FirstVertex));
+			}
+
+			auto Mesh = NewObject<UProceduralMeshComponent>(AnchorActor, TEXT("Mesh"));
+			Mesh->SetupAttachment(Root);
+			Mesh->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+			Mesh->CreateMeshSection(0, LocalVertices, Triangles, {}, {}, {}, {}, true);
+			Mesh->SetMaterial(0, SurfaceMaterial);
+			Mesh->SetVisibility(SurfaceMaterial != nullptr);
+			AnchorActor->AddInstanceComponent(Mesh);
+			Mesh->RegisterComponent();
+		}
+
+		// Classifications must be set before the component begins play and registers itself.
+		auto AnchorComponent = NewObject<UBlueprintXRSceneAnchorComponent>(AnchorActor, TEXT("SceneAnchor"));
+		AnchorComponent->SemanticClassifications = Capture->GetClassifications(Anchor);
+		AnchorActor->AddInstanceComponent(AnchorComponent);
+		AnchorComponent->RegisterComponent();
+
+		AnchorActors.Add(AnchorActor);
+	}
+
+	UE_LOG(LogPhanto, Log, TEXT("Replayed %d scene anchors and %d triangles from %s in %.2f ms"),
+		AnchorActors.Num(), Indices.Num() / 3, *FullPath, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return AnchorActors.Num() > 0;
+}
+
+void APhantoReplaySceneActor::ClearScene()
+{
+	for (auto AnchorActor : AnchorActors)
+	{
+		if (AnchorActor)
+			AnchorActor->Destroy();
+	}
+	AnchorActors.Reset();
+}
@@ -0,0 +1,422 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoRoamPointSubsystem.h"
+
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Phanto.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Roam Points Build"), STAT_PhantoRoamPointsBuild, STATGROUP_Phanto);
+DECLARE_CYCLE_STAT(TEXT("Roam Point Query"), STAT_PhantoRoamPointQuery, STATGROUP_Phanto);
+
+namespace PhantoRoamPoints
+{
+	uint32 MakeKey(int32 Region, uint8 Area)
+	{
+		return (uint32(Region) << 8) | Area;
+	}
+
+	/** Height of Point on the triangle ABC when it is inside it in the XY plane. */
+	bool GetHeightInTriangle(const FVector2D& Point, const FVector& A, const FVector& B, const FVector& C, double& OutZ)
+	{
+		auto const V0 = FVector2D(B - A);
+		auto const V1 = FVector2D(C - A);
+		auto const V2 = Point - FVector2D(A);
+		auto const Denominator = V0.X * V1.Y - V1.X * V0.Y;
+		if (FMath::IsNearlyZero(Denominator))
+			return false;
+
+		auto const U = (V2.X * V1.Y - V1.X * V2.Y) / Denominator;
+		auto const V = (V0.X * V2.Y - V2.X * V0.Y) / Denominator;
+		if (U < 0 || V < 0 || U + V > 1)
+			return false;
+
+		OutZ = A.Z + U * (B.Z - A.Z) + V * (C.Z - A.Z);
+		return true;
+	}
+}
+
+template <typename FunctorType>
+void UPhantoRoamPointSubsystem::ForEachPointInRadius(const FVector& Origin, float Radius, FunctorType&& Visitor) const
+{
+	if (GridStarts.Num() == 0 || Radius < 0)
+		return;
+
+	auto const CellSize = double(FMath::Max(GridCellSize, 1.f));
+	auto const MinX = FMath::Max(FMath::FloorToInt((Origin.X - Radius - GridOrigin.X) / CellSize), 0);
+	auto const MinY = FMath::Max(FMath::FloorToInt((Origin.Y - Radius - GridOrigin.Y) / CellSize), 0);
+	auto const MaxX = FMath::Min(FMath::FloorToInt((Origin.X + Radius - GridOrigin.X) / CellSize), GridSize.X - 1);
+	auto const MaxY = FMath::Min(FMath::FloorToInt((Origin.Y + Radius - GridOrigin.Y) / CellSize), GridSize.Y - 1);
+
+	auto const RadiusSquared = double(Radius) * Radius;
+	auto const Origin3f = FVector3f(Origin);
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			auto const Cell = Y * GridSize.X + X;
+			for (int32 Index = GridStarts[Cell]; Index < GridStarts[Cell + 1]; ++Index)
+			{
+				auto const Point = GridPoints[Index];
+				auto const DistanceSquared = double(FVector3f::DistSquared(Locations[Point], Origin3f));
+				if (DistanceSquared <= RadiusSquared)
+					Visitor(Point, DistanceSquared);
+			}
+		}
+	}
+}
+
+int32 UPhantoRoamPointSubsystem::RebuildRoamPoints()
+{
+	using namespace PhantoRoamPoints;
+	SCOPE_CYCLE_COUNTER(STAT_PhantoRoamPointsBuild);
+
+	Locations.Reset();
+	Regions.Reset();
+	Areas.Reset();
+	RegionRanges.Reset();
+	RegionAreaRanges.Reset();
+	GridStarts.Reset();
+	GridPoints.Reset();
+	GridSize = FIntPoint::ZeroValue;
+
+	auto NavMesh = Cast<ARecastNavMesh>(GetNavData());
+	if (!NavMesh)
+		return 0;
+
+	auto const StartTime = FPlatformTime::Seconds();
+
+	TArray<NavNodeRef> Polys;
+	TMap<NavNodeRef, int32> PolyIndices;
+	TArray<FNavPoly> TilePolys;
+	for (int32 Tile = 0; Tile < NavMesh->GetNavMeshTilesCount(); ++Tile)
+	{
+		TilePolys.Reset();
+		if (!NavMesh->GetPolysInTile(Tile, TilePolys))
+			continue;
+
+		for (auto const& Poly : TilePolys)
+		{
+			PolyIndices.Add(Poly.Ref, Polys.Num());
+			Polys.Add(Poly.Ref);
+		}
+	}
+
+	// Flood fill the poly graph to find the connected regions.
+	TArray<int32> PolyRegions;
+	PolyRegions.Init(INDEX_NONE, Polys.Num());
+	int32 NumRegions = 0;
+	TArray<int32> Stack;
+	TArray<NavNodeRef> Neighbors;
+	for (int32 Seed = 0; Seed < Polys.Num(); ++Seed)
+	{
+		if (PolyRegions[Seed] != INDEX_NONE)
+			continue;
+
+		PolyRegions[Seed] = NumRegions;
+		Stack.Add(Seed);
+		while (Stack.Num() > 0)
+		{
+			auto const Poly = Stack.Pop(EAllowShrinking::No);
+			Neighbors.Reset();
+			NavMesh->GetPolyNeighbors(Polys[Poly], Neighbors);
+			for (auto const Neighbor : Neighbors)
+			{
+				auto NeighborIndex = PolyIndices.Find(Neighbor);
+				if (NeighborIndex && PolyRegions[*NeighborIndex] == INDEX_NONE)
+				{
+					PolyRegions[*NeighborIndex] = NumRegions;
+					Stack.Add(*NeighborIndex);
+				}
+			}
+		}
+		++NumRegions;
+	}
+
+	struct FPoint
+	{
+		FVector3f Location;
+		int32 Region;
+		uint8 Area;
+	};
+
+	// One jittered sample per grid cell. The jitter only depends on the cell, so the same cell never gets two points
+	// from neighboring polys.
+	TArray<FPoint> Points;
+	TArray<FVector> Verts;
+	auto const Spacing = double(FMath::Max(PointSpacing, 1.f));
+	for (int32 Index = 0; Index < Polys.Num(); ++Index)
+	{
+		Verts.Reset();
+		if (!NavMesh->GetPolyVerts(Polys[Index], Verts) || Verts.Num() < 3)
+			continue;
+
+		auto const Area = uint8(NavMesh->GetPolyAreaID(Polys[Index]));
+		auto const Region = PolyRegions[Index];
+		auto const NumPointsBefore = Points.Num();
+
+		FBox2D PolyBounds(ForceInit);
+		for (auto const& Vert : Verts)
+		{
+			PolyBounds += FVector2D(Vert);
+		}
+
+		for (int32 Y = FMath::FloorToInt(PolyBounds.Min.Y / Spacing); Y <= FMath::FloorToInt(PolyBounds.Max.Y / Spacing); ++Y)
+		{
+			for (int32 X = FMath::FloorToInt(PolyBounds.Min.X / Spacing); X <= FMath::FloorToInt(PolyBounds.Max.X / Spacing); ++X)
+			{
+				FRandomStream CellRandom(int32(HashCombineFast(GetTypeHash(X), GetTypeHash(Y))));
+				auto const Sample = FVector2D(X + 0.1 + 0.8 * CellRandom.FRand(), Y + 0.1 + 0.8 * CellRandom.FRand()) * Spacing;
+				for (int32 Vert = 2; Vert < Verts.Num(); ++Vert)
+				{
+					double Z;
+					if (GetHeightInTriangle(Sample, Verts[0], Verts[Vert - 1], Verts[Vert], Z))
+					{
+						Points.Add({ FVector3f(Sample.X, Sample.Y, Z), Region, Area });
+						break;
+					}
+				}
+			}
+		}
+
+		// Keep narrow polys reachable as destinations.
+		if (Points.Num() == NumPointsBefore)
+		{
+			auto Center = FVector::ZeroVector;
+			for (auto const& Vert : Verts)
+			{
+				Center += Vert;
+			}
+			Points.Add({ FVector3f(Center / Verts.Num()), Region, Area });
+		}
+	}
+
+	if (Points.Num() == 0)
+		return 0;
+
+	Points.Sort([](const FPoint& A, const FPoint& B)
+	{
+		return MakeKey(A.Region, A.Area) < MakeKey(B.Region, B.Area);
+	});
+
+	Locations.Reserve(Points.Num());
+	Regions.Reserve(Points.Num());
+	Areas.Reserve(Points.Num());
+	RegionRanges.Init(FIntPoint(0, 0), NumRegions);
+	FBox2D PointBounds(ForceInit);
+	for (int32 Index = 0; Index < Points.Num(); ++Index)
+	{
+		auto const& Point = Points[Index];
+		Locations.Add(Point.Location);
+		Regions.Add(Point.Region);
+		Areas.Add(Point.Area);
+		PointBounds += FVector2D(Point.Location.X, Point.Location.Y);
+
+		auto& RegionRange = RegionRanges[Point.Region];
+		if (RegionRange.Y == 0)
+			RegionRange.X = Index;
+		++RegionRange.Y;
+
+		auto& RegionAreaRange = RegionAreaRanges.FindOrAdd(MakeKey(Point.Region, Point.Area), FIntPoint(Index, 0));
+		++RegionAreaRange.Y;
+	}
+
+	// Counting sort of the points into the grid cells.
+	auto const CellSize = double(FMath::Max(GridCellSize, 1.f));
+	GridOrigin = PointBounds.Min;
+	GridSize = FIntPoint(
+		FMath::FloorToInt((PointBounds.Max.X - GridOrigin.X) / CellSize) + 1,
+		FMath::FloorToInt((PointBounds.Max.Y - GridOrigin.Y) / CellSize) + 1);
+
+	auto CellOf = [this, CellSize](const FVector3f& Location)
+	{
+		auto const X = FMath::Clamp(FMath::FloorToInt((Location.X - GridOrigin.X) / CellSize), 0, GridSize.X - 1);
+		auto const Y = FMath::Clamp(FMath::FloorToInt((Location.Y - GridOrigin.Y) / CellSize), 0, GridSize.Y - 1);
+		return Y * GridSize.X + X;
+	};
+
+	GridStarts.Init(0, GridSize.X * GridSize.Y + 1);
+	for (auto const& Location : Locations)
+	{
+		++GridStarts[CellOf(Location) + 1];
+	}
+	for (int32 Cell = 1; Cell < GridStarts.Num(); ++Cell)
+	{
+		GridStarts[Cell] += GridStarts[Cell - 1];
+	}
+
+	TArray<int32> Cursors(GridStarts.GetData(), GridStarts.Num() - 1);
+	GridPoints.SetNumUninitialized(Locations.Num());
+	for (int32 Index = 0; Index < Locations.Num(); ++Index)
+	{
+		GridPoints[Cursors[CellOf(Locations[Index])]++] = Index;
+	}
+
+	UE_LOG(LogPhanto, Log, TEXT("Sampled %d roam points in %d regions from %d nav polys in %.2f ms"),
+		Locations.Num(), NumRegions, Polys.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return Locations.Num();
+}
+
+int32 UPhantoRoamPointSubsystem::GetRegionAt(const FVector& Location, float MaxDistance) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoRoamPointQuery);
+
+	auto ClosestPoint = INDEX_NONE;
+	auto ClosestDistanceSquared = TNumericLimits<double>::Max();
+	ForEachPointInRadius(Location, MaxDistance, [&](int32 Point, double DistanceSquared)
+	{
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestPoint = Point;
+			ClosestDistanceSquared = DistanceSquared;
+		}
+	});
+	return ClosestPoint != INDEX_NONE ? Regions[ClosestPoint] : INDEX_NONE;
+}
+
+bool UPhantoRoamPointSubsystem::GetRandomRoamPoint(FVector& OutLocation, int32 Region, TSubclassOf<UNavArea> AreaClass) const
+{
+	using namespace PhantoRoamPoints;
+	SCOPE_CYCLE_COUNTER(STAT_PhantoRoamPointQuery);
+
+	FIntPoint Range(0, Locations.Num());
+	if (AreaClass)
+	{
+		auto NavData = GetNavData();
+		auto const AreaID = NavData ? NavData->GetAreaID(AreaClass) : INDEX_NONE;
+		if (AreaID == INDEX_NONE)
+			return false;
+
+		if (Region != INDEX_NONE)
+		{
+			auto RegionAreaRange = RegionAreaRanges.Find(MakeKey(Region, uint8(AreaID)));
+			Range = RegionAreaRange ? *RegionAreaRange : FIntPoint(0, 0);
+		}
+		else
+		{
+			// Points of an area are split across regions; pick a range weighted by its number of points.
+			auto NumPoints = 0;
+			for (auto const& RegionAreaRange : RegionAreaRanges)
+			{
+				if ((RegionAreaRange.Key & 0xff) != uint32(AreaID))
+					continue;
+
+				NumPoints += RegionAreaRange.Value.Y;
+				if (FMath::RandRange(1, NumPoints) <= RegionAreaRange.Value.Y)
+					Range = RegionAreaRange.Value;
+			}
+			if (NumPoints == 0)
+				Range = FIntPoint(0, 0);
+		}
+	}
+	else if (Region != INDEX_NONE)
+	{
+		Range = RegionRanges.IsValidIndex(Region) ? RegionRanges[Region] : FIntPoint(0, 0);
+	}
+
+	if (Range.Y == 0)
+		return false;
+
+	OutLocation = FVector(Locations[Range.X + FMath::RandHelper(Range.Y)]);
+	return true;
+}
+
+bool UPhantoRoamPointSubsystem::GetRandomReachableRoamPoint(const FVector& Origin, float Radius, FVector& OutLocation) const
+{
+	auto const Region = GetRegionAt(Origin, GridCellSize);
+	if (Region == INDEX_NONE)
+		return false;
+
+	if (Radius <= 0)
+		return GetRandomRoamPoint(OutLocation, Region);
+
+	SCOPE_CYCLE_COUNTER(STAT_PhantoRoamPointQuery);
+
+	auto Picked = INDEX_NONE;
+	auto NumCandidates = 0;
+	ForEachPointInRadius(Origin, Radius, [&](int32 Point, double)
+	{
+		if (Regions[Point] == Region && FMath::RandRange(0, NumCandidates++) == 0)
+			Picked = Point;
+	});
+
+	if (Picked == INDEX_NONE)
+		return false;
+
+	OutLocation = FVector(Locations[Picked]);
+	return true;
+}
+
+bool UPhantoRoamPointSubsystem::GetNearestRoamPoint(const FVector& Origin, float Radius, FVector& OutLocation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoRoamPointQuery);
+
+	auto ClosestPoint = INDEX_NONE;
+	auto ClosestDistanceSquared = TNumericLimits<double>::Max();
+	ForEachPointInRadius(Origin, Radius, [&](int32 Point, double DistanceSquared)
+	{
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestPoint = Point;
+			ClosestDistanceSquared = DistanceSquared;
+		}
+	});
+
+	if (ClosestPoint == INDEX_NONE)
+		return false;
+
+	OutLocation = FVector(Locations[ClosestPoint]);
+	return true;
+}
+
+void UPhantoRoamPointSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(&InWorld))
+		NavSystem->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UPhantoRoamPointSubsystem::HandleNavigationGenerationFinished);
+
+	RebuildRoamPoints();
+}
+
+void UPhantoRoamPointSubsystem::Deinitialize()
+{
+	if (auto World = GetWorld())
+		World->GetTimerManager().ClearTimer(RebuildTimerHandle);
+
+	if (auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld()))
+		NavSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UPhantoRoamPointSubsystem::HandleNavigationGenerationFinished);
+
+	Super::Deinitialize();
+}
+
+ANavigationData* UPhantoRoamPointSubsystem::GetNavData() const
+{
+	auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	return NavSystem ? NavSystem->GetDefaultNavDataInstance() : nullptr;
+}
+
+void UPhantoRoamPointSubsystem::HandleNavigationGenerationFinished(ANavigationData* NavData)
+{
+	if (!bRebuildAfterNavigationBuild || NavData != GetNavData())
+		return;
+
+	// Rebuilding samples the whole navmesh, so a burst of small builds (e.g. links registered one after the other)
+	// only resamples once, RebuildDelay after the last one.
+	if (RebuildDelay <= 0)
+	{
+		RebuildRoamPoints();
+		return;
+	}
+
+	GetWorld()->GetTimerManager().SetTimer(RebuildTimerHandle, FTimerDelegate::CreateWeakLambda(this, [this]
+	{
+		auto NavSystem = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+		if (NavSystem && NavSystem->IsNavigationBuildInProgress())
+			return; // Rescheduled when that build finishes.
+
+		RebuildRoamPoints();
+	}), RebuildDelay, false);
+}
@@ -0,0 +1,168 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoSceneAnchorRegistry.h"
+
+#include "BlueprintXRSceneAnchorComponent.h"
+#include "GameFramework/Actor.h"
+
+void UPhantoSceneAnchorRegistry::RegisterAnchor(UBlueprintXRSceneAnchorComponent* Anchor)
+{
+	if (!Anchor || Indices.Contains(Anchor))
+		return;
+
+	auto const Index = Anchors.Add(Anchor);
+	Actors.AddDefaulted();
+	Labels.AddDefaulted();
+	Bounds.AddDefaulted();
+	Data.AddDefaulted();
+	Indices.Add(Anchor, Index);
+	WriteRow(Index, *Anchor);
+}
+
+void UPhantoSceneAnchorRegistry::UnregisterAnchor(UBlueprintXRSceneAnchorComponent* Anchor)
+{
+	if (auto Index = Indices.Find(Anchor))
+		RemoveRow(*Index);
+}
+
+void UPhantoSceneAnchorRegistry::RemoveRow(int32 Index)
+{
+	Indices.Remove(Anchors[Index]);
+	Anchors.RemoveAtSwap(Index, EAllowShrinking::No);
+	Actors.RemoveAtSwap(Index, EAllowShrinking::No);
+	Labels.RemoveAtSwap(Index, EAllowShrinking::No);
+	Bounds.RemoveAtSwap(Index, EAllowShrinking::No);
+	Data.RemoveAtSwap(Index, EAllowShrinking::No);
+	if (Index < Anchors.Num())
+		Indices.Add(Anchors[Index], Index);
+	++Version;
+}
+
+void UPhantoSceneAnchorRegistry::UpdateAnchor(UBlueprintXRSceneAnchorComponent* Anchor)
+{
+	if (!Anchor)
+		return;
+
+	if (auto Index = Indices.Find(Anchor))
+		WriteRow(*Index, *Anchor);
+	else
+		RegisterAnchor(Anchor);
+}
+
+void UPhantoSceneAnchorRegistry::RefreshAnchors()
+{
+	for (auto Index = Anchors.Num() - 1; Index >= 0; --Index)
+	{
+		if (auto Anchor = Anchors[Index].Get())
+			WriteRow(Index, *Anchor);
+		else
+			RemoveRow(Index);
+	}
+}
+
+void UPhantoSceneAnchorRegistry::WriteRow(int32 Index, UBlueprintXRSceneAnchorComponent& Anchor)
+{
+	auto Owner = Anchor.GetOwner();
+	auto& Row = Data[Index];
+	Row.Label = PhantoScene::GetLabelFromClassifications(Anchor.SemanticClassifications);
+	Row.Bounds = Owner ? Owner->GetComponentsBoundingBox(true) : FBox(ForceInit);
+
+	// Scene actors size their anchors by scale; the thinnest axis of a plane is its normal.
+	if (Owner)
+	{
+		auto const Local = Owner->CalculateComponentsBoundingBoxInLocalSpace(true);
+		auto const Size = Local.IsValid ? Local.GetSize() * Owner->GetActorScale3D().GetAbs() : FVector::ZeroVector;
+		auto const Thinnest = Size.X <= Size.Y ? (Size.X <= Size.Z ? 0 : 2) : (Size.Y <= Size.Z ? 1 : 2);
+		Row.VolumeSize = Size;
+		Row.bIsPlane = Size[Thinnest] < 1;
+		Row.PlaneSize = FVector2D(Size[(Thinnest + 1) % 3], Size[(Thinnest + 2) % 3]);
+		Row.PlaneNormal = Owner->GetActorTransform().GetUnitAxis(EAxis::Type(Thinnest + 1));
+	}
+
+	Actors[Index] = Owner;
+	Labels[Index] = Row.Label;
+	Bounds[Index] = Row.Bounds;
+	++Version;
+}
+
+int32 UPhantoSceneAnchorRegistry::GetNumAnchors(EPhantoSemanticLabel Label) const
+{
+	if (Label == EPhantoSemanticLabel::Unknown)
+		return Anchors.Num();
+
+	auto Count = 0;
+	for (auto AnchorLabel : Labels)
+	{
+		Count += AnchorLabel == Label;
+	}
+	return Count;
+}
+
+int32 UPhantoSceneAnchorRegistry::GetAnchors(EPhantoSemanticLabel Label, TArray<UBlueprintXRSceneAnchorComponent*>& OutAnchors) const
+{
+	OutAnchors.Reset();
+	for (auto Index = 0; Index < Labels.Num(); ++Index)
+	{
+		if (Label != EPhantoSemanticLabel::Unknown && Labels[Index] != Label)
+			continue;
+
+		if (auto Anchor = Anchors[Index].Get())
+			OutAnchors.Add(Anchor);
+	}
+	return OutAnchors.Num();
+}
+
+int32 UPhantoSceneAnchorRegistry::GetAnchorsInRadius(EPhantoSemanticLabel Label, const FVector& Location, float Radius,
+	TArray<UBlueprintXRSceneAnchorComponent*>& OutAnchors) const
+{
+	OutAnchors.Reset();
+	auto const RadiusSquared = FMath::Square(double(Radius));
+	for (auto Index = 0; Index < Labels.Num(); ++Index)
+	{
+		if (Label != EPhantoSemanticLabel::Unknown && Labels[Index] != Label)
+			continue;
+
+		if (Bounds[Index].ComputeSquaredDistanceToPoint(Location) > RadiusSquared)
+			continue;
+
+		if (auto Anchor = Anchors[Index].Get())
+			OutAnchors.Add(Anchor);
+	}
+	return OutAnchors.Num();
+}
+
+UBlueprintXRSceneAnchorComponent* UPhantoSceneAnchorRegistry::FindNearestAnchor(EPhantoSemanticLabel Label, const FVector& Location, float MaxDistance) const
+{
+	auto Nearest = INDEX_NONE;
+	auto NearestDistanceSquared = MaxDistance > 0 ? FMath::Square(double(MaxDistance)) : TNumericLimits<double>::Max();
+	for (auto Index = 0; Index < Labels.Num(); ++Index)
+	{
+		if (Label != EPhantoSemanticLabel::Unknown && Labels[Index] != Label)
+			continue;
+
+		auto const DistanceSquared = Bounds[Index].ComputeSquaredDistanceToPoint(Location);
+		if (DistanceSquared <= NearestDistanceSquared && Anchors[Index].IsValid())
+		{
+			Nearest = Index;
+			NearestDistanceSquared = DistanceSquared;
+		}
+	}
+	return Nearest != INDEX_NONE ? Anchors[Nearest].Get() : nullptr;
+}
+
+bool UPhantoSceneAnchorRegistry::GetAnchorData(const UBlueprintXRSceneAnchorComponent* Anchor, FPhantoSceneAnchorData& OutData) const
+{
+	auto Index = Indices.Find(Anchor);
+	if (!Index)
+		return false;
+
+	OutData = Data[*Index];
+	return true;
+}
+
+EPhantoSemanticLabel UPhantoSceneAnchorRegistry::GetActorLabel(const AActor* Actor) const
+{
+	auto const Index = Actors.IndexOfByKey(Actor);
+	return Index != INDEX_NONE ? Labels[Index] : EPhantoSemanticLabel::Unknown;
+}
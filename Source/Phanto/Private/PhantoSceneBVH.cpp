@@ -0,0 +1,535 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoSceneBVH.h"
+
+#include "Algo/Partition.h"
+#include "Async/ParallelFor.h"
+#include "PhantoSceneGeometry.h"
+#include "Tasks/Task.h"
+
+static_assert(sizeof(FPhantoSceneBVH::FNode) == 32, "BVH nodes should stay 32 bytes, two per cache line");
+
+namespace
+{
+	struct FBuildTriangle
+	{
+		FVector3f Min;
+		FVector3f Max;
+		FVector3f Centroid;
+	};
+
+	float HalfArea(const FBox3f& Box)
+	{
+		if (!Box.IsValid)
+			return 0;
+
+		auto const Size = Box.GetSize();
+		return Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X;
+	}
+
+	/** Splits recursively, appending the nodes of each subtree depth-first. */
+	struct FBuilder
+	{
+		static constexpr int32 NumBins = 16;
+
+		/** Below this many triangles a subtree isn't worth a task. */
+		static constexpr int32 ParallelThreshold = 4096;
+
+		const TArray<FBuildTriangle>& Triangles;
+		TArray<int32>& Order;
+		int32 MaxLeafTriangles;
+
+		void Build(int32 Start, int32 Count, TArray<FPhantoSceneBVH::FNode>& Out) const
+		{
+			FBox3f Bounds(ForceInit);
+			FBox3f CentroidBounds(ForceInit);
+			for (auto i = Start; i < Start + Count; ++i)
+			{
+				auto const& Triangle = Triangles[Order[i]];
+				Bounds += FBox3f(Triangle.Min, Triangle.Max);
+				CentroidBounds += Triangle.Centroid;
+			}
+
+			auto const NodeIndex = Out.Add({ Bounds.Min, uint32(Start), Bounds.Max, uint32(Count) });
+			if (Count <= MaxLeafTriangles)
+				return;
+
+			auto const Mid = Split(Start, Count, CentroidBounds);
+			Out[NodeIndex].Count = 0;
+
+			if (Count < ParallelThreshold)
+			{
+				Build(Start, Mid - Start, Out);
+				Out[NodeIndex].Data = uint32(Out.Num());
+				Build(Mid, Start + Count - Mid, Out);
+				return;
+			}
+
+			// The halves partition disjoint ranges of Order, each builds its own node array.
+			TArray<FPhantoSceneBVH::FNode> Left;
+			TArray<FPhantoSceneBVH::FNode> Right;
+			auto LeftTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Start, Mid, &Left]
+			{
+				Build(Start, Mid - Start, Left);
+			});
+			Build(Mid, Start + Count - Mid, Right);
+			LeftTask.Wait();
+
+			Append(Left, Out);
+			Out[NodeIndex].Data = uint32(Out.Num());
+			Append(Right, Out);
+		}
+
+		static void Append(const TArray<FPhantoSceneBVH::FNode>& Subtree, TArray<FPhantoSceneBVH::FNode>& Out)
+		{
+			auto const Offset = uint32(Out.Num());
+			Out.Append(Subtree);
+			for (auto i = Offset; i < uint32(Out.Num()); ++i)
+			{
+				if (Out[i].Count == 0)
+					Out[i].Data += Offset;
+			}
+		}
+
+		/** Partitions the range on the cheapest binned SAH plane of the widest centroid axis. Returns the split index. */
+		int32 Split(int32 Start, int32 Count, const FBox3f& CentroidBounds) const
+		{
+			auto const Extent = CentroidBounds.GetSize();
+			auto const Axis = Extent.X > Extent.Y ? (Extent.X > Extent.Z ? 0 : 2) : (Extent.Y > Extent.Z ? 1 : 2);
+			if (Extent[Axis] <= UE_KINDA_SMALL_NUMBER)
+				return Start + Count / 2;
+
+			auto const Scale = NumBins / Extent[Axis];
+			auto const BinOf = [this, Axis, Scale, &CentroidBounds](int32 Triangle)
+			{
+				return FMath::Min(int32((Triangles[Triangle].Centroid[Axis] - CentroidBounds.Min[Axis]) * Scale), NumBins - 1);
+			};
+
+			FBox3f BinBounds[NumBins];
+			int32 BinCounts[NumBins] = {};
+			for (auto& Box : BinBounds)
+			{
+				Box.Init();
+			}
+			for (auto i = Start; i < Start + Count; ++i)
+			{
+				auto const Bin = BinOf(Order[i]);
+				BinBounds[Bin] += FBox3f(Triangles[Order[i]].Min, Triangles[Order[i]].Max);
+				++BinCounts[Bin];
+			}
+
+			float RightCosts[NumBins] = {};
+			FBox3f Accumulated(ForceInit);
+			auto Accumulator = 0;
+			for (auto Bin = NumBins - 1; Bin > 0; --Bin)
+			{
+				Accumulated += BinBounds[Bin];
+				Accumulator += BinCounts[Bin];
+				RightCosts[Bin] = Accumulator > 0 ? HalfArea(Accumulated) * Accumulator : -1;
+			}
+
+			auto BestBin = INDEX_NONE;
+			auto BestCost = TNumericLimits<float>::Max();
+			Accumulated.Init();
+			Accumulator = 0;
+			for (auto Bin = 0; Bin < NumBins - 1; ++Bin)
+			{
+				Accumulated += BinBounds[Bin];
+				Accumulator += BinCounts[Bin];
+				if (Accumulator == 0 || RightCosts[Bin + 1] < 0)
+					continue;
+
+				auto const Cost = HalfArea(Accumulated) * Accumulator + RightCosts[Bin + 1];
+				if (Cost < BestCost)
+				{
+					BestCost = Cost;
+					BestBin = Bin;
+				}
+			}
+
+			if (BestBin == INDEX_NONE)
+				return Start + Count / 2;
+
+			auto const NumLeft = Algo::Partition(Order.GetData() + Start, Count, [&BinOf, BestBin](int32 Triangle)
+			{
+				return BinOf(Triangle) <= BestBin;
+			});
+			return NumLeft > 0 && NumLeft < Count ? Start + NumLeft : Start + Count / 2;
+		}
+	};
+
+	/** Four lanes of a vector, one register per axis. */
+	struct FLanes
+	{
+		VectorRegister4Float X;
+		VectorRegister4Float Y;
+		VectorRegister4Float Z;
+	};
+
+	FORCEINLINE FLanes Load(const float (&Axes)[3][4])
+	{
+		return { VectorLoadAligned(Axes[0]), VectorLoadAligned(Axes[1]), VectorLoadAligned(Axes[2]) };
+	}
+
+	FORCEINLINE FLanes Splat(const FVector3f& Vector)
+	{
+		return { VectorSetFloat1(Vector.X), VectorSetFloat1(Vector.Y), VectorSetFloat1(Vector.Z) };
+	}
+
+	FORCEINLINE VectorRegister4Float Dot(const FLanes& A, const FLanes& B)
+	{
+		return VectorMultiplyAdd(A.Z, B.Z, VectorMultiplyAdd(A.Y, B.Y, VectorMultiply(A.X, B.X)));
+	}
+
+	FORCEINLINE FLanes Cross(const FLanes& A, const FLanes& B)
+	{
+		return {
+			VectorNegateMultiplyAdd(A.Z, B.Y, VectorMultiply(A.Y, B.Z)),
+			VectorNegateMultiplyAdd(A.X, B.Z, VectorMultiply(A.Z, B.X)),
+			VectorNegateMultiplyAdd(A.Y, B.X, VectorMultiply(A.X, B.Y)) };
+	}
+
+	FORCEINLINE FLanes Subtract(const FLanes& A, const FLanes& B)
+	{
+		return { VectorSubtract(A.X, B.X), VectorSubtract(A.Y, B.Y), VectorSubtract(A.Z, B.Z) };
+	}
+
+	FORCEINLINE FVector3f GetLane(const float (&Axes)[3][4], int32 Lane)
+	{
+		return FVector3f(Axes[0][Lane], Axes[1][Lane], Axes[2][Lane]);
+	}
+
+	/** Möller-Trumbore against the four triangles of a block. Returns the lane of the nearest hit below BestTime. */
+	FORCEINLINE int32 IntersectBlock(const FPhantoSceneBVH::FTriangleBlock& Block, const FLanes& Origin, const FLanes& Direction, float& BestTime)
+	{
+		auto const E1 = Load(Block.E1);
+		auto const E2 = Load(Block.E2);
+		auto const P = Cross(Direction, E2);
+		auto const Determinant = Dot(E1, P);
+		auto const InverseDeterminant = VectorDivide(VectorOne(), Determinant);
+
+		auto const T = Subtract(Origin, Load(Block.V0));
+		auto const U = VectorMultiply(Dot(T, P), InverseDeterminant);
+		auto const Q = Cross(T, E1);
+		auto const V = VectorMultiply(Dot(Direction, Q), InverseDeterminant);
+		auto const Time = VectorMultiply(Dot(E2, Q), InverseDeterminant);
+
+		auto const Zero = VectorZero();
+		auto Mask = VectorCompareGT(VectorAbs(Determinant), VectorSetFloat1(UE_SMALL_NUMBER));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareGE(U, Zero));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareGE(V, Zero));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareLE(VectorAdd(U, V), VectorOne()));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareGE(Time, Zero));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareLT(Time, VectorSetFloat1(BestTime)));
+
+		auto const Bits = VectorMaskBits(Mask);
+		if (!Bits)
+			return INDEX_NONE;
+
+		alignas(16) float Times[4];
+		VectorStoreAligned(Time, Times);
+		auto BestLane = INDEX_NONE;
+		for (auto Lane = 0; Lane < 4; ++Lane)
+		{
+			if ((Bits & (1 << Lane)) && Times[Lane] < BestTime)
+			{
+				BestTime = Times[Lane];
+				BestLane = Lane;
+			}
+		}
+		return BestLane;
+	}
+
+	FORCEINLINE float DistanceSquaredToBox(const FPhantoSceneBVH::FNode& Node, const FVector3f& Point)
+	{
+		auto const Below = Node.Min - Point;
+		auto const Above = Point - Node.Max;
+		return FVector3f(FMath::Max3(Below.X, Above.X, 0.f), FMath::Max3(Below.Y, Above.Y, 0.f), FMath::Max3(Below.Z, Above.Z, 0.f)).SizeSquared();
+	}
+}
+
+void FPhantoSceneBVH::Build(const FPhantoSceneMeshData& Mesh, int32 MaxLeafTriangles)
+{
+	Nodes.Reset();
+	Blocks.Reset();
+	NumTriangles = Mesh.GetNumTriangles();
+	if (NumTriangles == 0)
+		return;
+
+	TArray<FBuildTriangle> Triangles;
+	Triangles.SetNumUninitialized(NumTriangles);
+	ParallelFor(NumTriangles, [&](int32 Index)
+	{
+		auto const& A = Mesh.Vertices[Mesh.Indices[Index * 3]];
+		auto const& B = Mesh.Vertices[Mesh.Indices[Index * 3 + 1]];
+		auto const& C = Mesh.Vertices[Mesh.Indices[Index * 3 + 2]];
+		Triangles[Index] = { A.ComponentMin(B).ComponentMin(C), A.ComponentMax(B).ComponentMax(C), (A + B + C) / 3.f };
+	});
+
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumTriangles);
+	for (auto i = 0; i < NumTriangles; ++i)
+	{
+		Order[i] = i;
+	}
+
+	Nodes.Reserve(NumTriangles * 2 / FMath::Clamp(MaxLeafTriangles, 1, 4));
+	FBuilder{ Triangles, Order, FMath::Clamp(MaxLeafTriangles, 1, 4) }.Build(0, NumTriangles, Nodes);
+
+	// Leaves point into Order until their triangles are packed into blocks.
+	for (auto& Node : Nodes)
+	{
+		if (Node.Count == 0)
+			continue;
+
+		auto const First = Node.Data;
+		Node.Data = uint32(Blocks.Num());
+		for (uint32 i = 0; i < Node.Count; i += 4)
+		{
+			auto& Block = Blocks.AddZeroed_GetRef();
+			for (auto Lane = 0; Lane < 4; ++Lane)
+			{
+				Block.Triangles[Lane] = INDEX_NONE;
+				if (i + Lane >= Node.Count)
+					continue;
+
+				auto const Triangle = Order[First + i + Lane];
+				auto const& A = Mesh.Vertices[Mesh.Indices[Triangle * 3]];
+				auto const E1 = Mesh.Vertices[Mesh.Indices[Triangle * 3 + 1]] - A;
+				auto const E2 = Mesh.Vertices[Mesh.Indices[Triangle * 3 + 2]] - A;
+				auto const Normal = FVector3f::CrossProduct(E1, E2).GetSafeNormal();
+				for (auto Axis = 0; Axis < 3; ++Axis)
+				{
+					Block.V0[Axis][Lane] = A[Axis];
+					Block.E1[Axis][Lane] = E1[Axis];
+					Block.E2[Axis][Lane] = E2[Axis];
+					Block.N[Axis][Lane] = Normal[Axis];
+				}
+				Block.Triangles[Lane] = Triangle;
+			}
+		}
+	}
+}
+
+FBox FPhantoSceneBVH::GetBounds() const
+{
+	return Nodes.Num() > 0 ? FBox(FVector(Nodes[0].Min), FVector(Nodes[0].Max)) : FBox(ForceInit);
+}
+
+bool FPhantoSceneBVH::Raycast(const FVector& Start, const FVector& End, FPhantoSceneBVHHit& OutHit) const
+{
+	auto const Origin = FVector3f(Start);
+	auto const Direction = FVector3f(End - Start);
+	if (Nodes.Num() == 0 || Direction.IsNearlyZero())
+		return false;
+
+	auto const SafeInverse = [](float Value)
+	{
+		return FMath::Abs(Value) > UE_SMALL_NUMBER ? 1.f / Value : (Value >= 0 ? UE_BIG_NUMBER : -UE_BIG_NUMBER);
+	};
+	auto const InverseDirection = FVector3f(SafeInverse(Direction.X), SafeInverse(Direction.Y), SafeInverse(Direction.Z));
+
+	// Entry time of the segment into a node, or a negative value when it misses or enters after BestTime.
+	auto BestTime = 1.f;
+	auto const EntryTime = [&](const FNode& Node)
+	{
+		auto const T1 = (Node.Min - Origin) * InverseDirection;
+		auto const T2 = (Node.Max - Origin) * InverseDirection;
+		auto const Near = FMath::Max3(FMath::Min(T1.X, T2.X), FMath::Min(T1.Y, T2.Y), FMath::Min(T1.Z, T2.Z));
+		auto const Far = FMath::Min3(FMath::Max(T1.X, T2.X), FMath::Max(T1.Y, T2.Y), FMath::Max(T1.Z, T2.Z));
+		return Near <= Far && Far >= 0 && Near <= BestTime ? FMath::Max(Near, 0.f) : -1.f;
+	};
+
+	auto const OriginLanes = Splat(Origin);
+	auto const DirectionLanes = Splat(Direction);
+	auto BestBlock = INDEX_NONE;
+	auto BestLane = INDEX_NONE;
+
+	TPair<uint32, float> Stack[64];
+	int32 StackSize = 0;
+	if (EntryTime(Nodes[0]) >= 0)
+		Stack[StackSize++] = { 0, 0.f };
+
+	while (StackSize > 0)
+	{
+		auto const [Index, Entry] = Stack[--StackSize];
+		if (Entry > BestTime)
+			continue;
+
+		auto const& Node = Nodes[Index];
+		if (Node.Count > 0)
+		{
+			for (auto Block = Node.Data; Block < Node.Data + (Node.Count + 3) / 4; ++Block)
+			{
+				auto const Lane = IntersectBlock(Blocks[Block], OriginLanes, DirectionLanes, BestTime);
+				if (Lane != INDEX_NONE)
+				{
+					BestBlock = int32(Block);
+					BestLane = Lane;
+				}
+			}
+			continue;
+		}
+
+		// Nearest child on top of the stack.
+		auto const Left = Index + 1;
+		auto const Right = Node.Data;
+		auto const LeftEntry = EntryTime(Nodes[Left]);
+		auto const RightEntry = EntryTime(Nodes[Right]);
+		auto const bLeftFirst = LeftEntry >= 0 && (RightEntry < 0 || LeftEntry <= RightEntry);
+		if (StackSize + 2 > UE_ARRAY_COUNT(Stack))
+			break;
+
+		if (bLeftFirst)
+		{
+			if (RightEntry >= 0)
+				Stack[StackSize++] = { Right, RightEntry };
+			Stack[StackSize++] = { Left, LeftEntry };
+		}
+		else
+		{
+			if (LeftEntry >= 0)
+				Stack[StackSize++] = { Left, LeftEntry };
+			if (RightEntry >= 0)
+				Stack[StackSize++] = { Right, RightEntry };
+		}
+	}
+
+	if (BestBlock == INDEX_NONE)
+		return false;
+
+	auto const& Block = Blocks[BestBlock];
+	auto const Normal = GetLane(Block.N, BestLane);
+	OutHit.Location = Start + (End - Start) * BestTime;
+	OutHit.Normal = FVector(FVector3f::DotProduct(Normal, Direction) > 0 ? -Normal : Normal);
+	OutHit.Distance = BestTime * Direction.Size();
+	OutHit.Triangle = Block.Triangles[BestLane];
+	return true;
+}
+
+template <typename FunctorType>
+void FPhantoSceneBVH::ForEachTriangleNear(const FVector3f& Point, float& BestDistanceSquared, FunctorType&& Visitor) const
+{
+	if (Nodes.Num() == 0)
+		return;
+
+	auto const PointLanes = Splat(Point);
+
+	TPair<uint32, float> Stack[64];
+	int32 StackSize = 0;
+	Stack[StackSize++] = { 0, DistanceSquaredToBox(Nodes[0], Point) };
+
+	while (StackSize > 0)
+	{
+		auto const [Index, DistanceSquared] = Stack[--StackSize];
+		if (DistanceSquared > BestDistanceSquared)
+			continue;
+
+		auto const& Node = Nodes[Index];
+		if (Node.Count > 0)
+		{
+			for (auto Block = Node.Data; Block < Node.Data + (Node.Count + 3) / 4; ++Block)
+			{
+				// The distance to the plane of a triangle is a lower bound of the distance to the triangle.
+				auto const& TriangleBlock = Blocks[Block];
+				auto const PlaneDistance = Dot(Subtract(PointLanes, Load(TriangleBlock.V0)), Load(TriangleBlock.N));
+				auto const Mask = VectorCompareLE(VectorMultiply(PlaneDistance, PlaneDistance), VectorSetFloat1(BestDistanceSquared));
+				auto const Bits = VectorMaskBits(Mask);
+				for (auto Lane = 0; Lane < 4; ++Lane)
+				{
+					if ((Bits & (1 << Lane)) && TriangleBlock.Triangles[Lane] != INDEX_NONE)
+					{
+						if (!Visitor(TriangleBlock, Lane, BestDistanceSquared))
+							return;
+					}
+				}
+			}
+			continue;
+		}
+
+		auto const Left = Index + 1;
+		auto const Right = Node.Data;
+		auto const LeftDistance = DistanceSquaredToBox(Nodes[Left], Point);
+		auto const RightDistance = DistanceSquaredToBox(Nodes[Right], Point);
+		if (StackSize + 2 > UE_ARRAY_COUNT(Stack))
+			break;
+
+		if (LeftDistance <= RightDistance)
+		{
+			Stack[StackSize++] = { Right, RightDistance };
+			Stack[StackSize++] = { Left, LeftDistance };
+		}
+		else
+		{
+			Stack[StackSize++] = { Left, LeftDistance };
+			Stack[StackSize++] = { Right, RightDistance };
+		}
+	}
+}
+
+namespace
+{
+	FVector ClosestPointOnLane(const FPhantoSceneBVH::FTriangleBlock& Block, int32 Lane, const FVector& Point)
+	{
+		auto const A = FVector(GetLane(Block.V0, Lane));
+		return FMath::ClosestPointOnTriangleToPoint(Point, A, A + FVector(GetLane(Block.E1, Lane)), A + FVector(GetLane(Block.E2, Lane)));
+	}
+}
+
+bool FPhantoSceneBVH::ClosestPoint(const FVector& Point, float MaxDistance, FPhantoSceneBVHHit& OutHit) const
+{
+	auto BestDistanceSquared = MaxDistance > 0 ? FMath::Square(MaxDistance) : TNumericLimits<float>::Max();
+	const FTriangleBlock* BestBlock = nullptr;
+	auto BestLane = INDEX_NONE;
+	FVector BestPoint;
+
+	ForEachTriangleNear(FVector3f(Point), BestDistanceSquared, [&](const FTriangleBlock& Block, int32 Lane, float& DistanceSquared)
+	{
+		auto const Closest = ClosestPointOnLane(Block, Lane, Point);
+		auto const CandidateSquared = float(FVector::DistSquared(Closest, Point));
+		if (CandidateSquared <= DistanceSquared)
+		{
+			DistanceSquared = CandidateSquared;
+			BestBlock = &Block;
+			BestLane = Lane;
+			BestPoint = Closest;
+		}
+		return true;
+	});
+
+	if (!BestBlock)
+		return false;
+
+	auto const Normal = FVector(GetLane(BestBlock->N, BestLane));
+	OutHit.Location = BestPoint;
+	OutHit.Normal = FVector::DotProduct(Normal, Point - BestPoint) < 0 ? -Normal : Normal;
+	OutHit.Distance = FMath::Sqrt(BestDistanceSquared);
+	OutHit.Triangle = BestBlock->Triangles[BestLane];
+	return true;
+}
+
+int32 FPhantoSceneBVH::SphereOverlap(const FVector& Center, float Radius, TArray<int32>& OutTriangles) const
+{
+	auto const NumBefore = OutTriangles.Num();
+	auto RadiusSquared = FMath::Square(Radius);
+	ForEachTriangleNear(FVector3f(Center), RadiusSquared, [&](const FTriangleBlock& Block, int32 Lane, float& DistanceSquared)
+	{
+		if (FVector::DistSquared(ClosestPointOnLane(Block, Lane, Center), Center) <= DistanceSquared)
+			OutTriangles.Add(Block.Triangles[Lane]);
+		return true;
+	});
+	return OutTriangles.Num() - NumBefore;
+}
+
+bool FPhantoSceneBVH::OverlapsSphere(const FVector& Center, float Radius) const
+{
+	auto bOverlaps = false;
+	auto RadiusSquared = FMath::Square(Radius);
+	ForEachTriangleNear(FVector3f(Center), RadiusSquared, [&](const FTriangleBlock& Block, int32 Lane, float& DistanceSquared)
+	{
+		bOverlaps = FVector::DistSquared(ClosestPointOnLane(Block, Lane, Center), Center) <= DistanceSquared;
+		return !bOverlaps;
+	});
+	return bOverlaps;
+}
@@ -0,0 +1,151 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoSceneBVHSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Phanto.h"
+#include "PhantoSceneBVH.h"
+#include "PhantoSceneGeometry.h"
+
+DECLARE_CYCLE_STAT(TEXT("Scene BVH Build"), STAT_PhantoSceneBVHBuild, STATGROUP_Phanto);
+DECLARE_MEMORY_STAT(TEXT("Scene BVH Memory"), STAT_PhantoSceneBVHMemory, STATGROUP_Phanto);
+
+float UPhantoSceneBVHSubsystem::BuildFromActors(const TArray<AActor*>& Actors)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhantoSceneBVHBuild);
+
+	auto const StartTime = FPlatformTime::Seconds();
+	auto const Mesh = PhantoSceneGeometry::GatherTriangles(Actors);
+	auto const GatherMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	auto NewBVH = MakeShared<FPhantoSceneBVH>();
+	NewBVH->Build(Mesh);
+	BVH = NewBVH;
+
+	auto const BuildMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	SET_MEMORY_STAT(STAT_PhantoSceneBVHMemory, BVH->GetAllocatedSize());
+	UE_LOG(LogPhanto, Log, TEXT("Scene BVH built in %.2f ms (%.2f ms gathering): %d triangles, %d nodes, %llu bytes"),
+		BuildMs, GatherMs, BVH->GetNumTriangles(), BVH->GetNumNodes(), uint64(BVH->GetAllocatedSize()));
+	return BuildMs;
+}
+
+void UPhantoSceneBVHSubsystem::Clear()
+{
+	BVH.Reset();
+	SET_MEMORY_STAT(STAT_PhantoSceneBVHMemory, 0);
+}
+
+bool UPhantoSceneBVHSubsystem::Raycast(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal, float& OutDistance) const
+{
+	FPhantoSceneBVHHit Hit;
+	if (!BVH || !BVH->Raycast(Start, End, Hit))
+		return false;
+
+	OutLocation = Hit.Location;
+	OutNormal = Hit.Normal;
+	OutDistance = Hit.Distance;
+	return true;
+}
+
+bool UPhantoSceneBVHSubsystem::ClosestPoint(const FVector& Point, float MaxDistance, FVector& OutLocation, FVector& OutNormal, float& OutDistance) const
+{
+	FPhantoSceneBVHHit Hit;
+	if (!BVH || !BVH->ClosestPoint(Point, MaxDistance, Hit))
+		return false;
+
+	OutLocation = Hit.Location;
+	OutNormal = Hit.Normal;
+	OutDistance = Hit.Distance;
+	return true;
+}
+
+bool UPhantoSceneBVHSubsystem::OverlapsSphere(const FVector& Center, float Radius) const
+{
+	return BVH && BVH->OverlapsSphere(Center, Radius);
+}
+
+int32 UPhantoSceneBVHSubsystem::SphereOverlap(const FVector& Center, float Radius, TArray<int32>& OutTriangles) const
+{
+	OutTriangles.Reset();
+	return BVH ? BVH->SphereOverlap(Center, Radius, OutTriangles) : 0;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkSceneBVHCommand(
+	TEXT("Phanto.Bench.SceneBVH"),
+	TEXT("Compares scene BVH raycasts and sphere overlaps with physics traces over the built room. Usage: Phanto.Bench.SceneBVH [NumQueries=10000] [Radius=10]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](TArray<FString> const& Args, UWorld* World)
+	{
+		auto Subsystem = World ? World->GetSubsystem<UPhantoSceneBVHSubsystem>() : nullptr;
+		auto BVH = Subsystem ? Subsystem->GetBVH() : nullptr;
+		if (!BVH || BVH->IsEmpty())
+		{
+			UE_LOG(LogPhanto, Warning, TEXT("Phanto.Bench.SceneBVH: the scene BVH isn't built"));
+			return;
+		}
+
+		auto const NumQueries = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+		auto const Radius = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 10.f;
+
+		// Random segments crossing the room, from points inside its bounds.
+		auto const Bounds = BVH->GetBounds();
+		auto const Length = Bounds.GetSize().Size();
+		FRandomStream Random(NumQueries);
+		TArray<FVector> Starts, Ends;
+		for (auto i = 0; i < NumQueries; ++i)
+		{
+			Starts.Add(Random.RandPointInBox(Bounds));
+			Ends.Add(Starts.Last() + Random.VRand() * Length);
+		}
+
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(PhantoBenchSceneBVH));
+		TArray<float> PhysicsDistances;
+		PhysicsDistances.SetNumUninitialized(NumQueries);
+		auto const PhysicsRayStart = FPlatformTime::Seconds();
+		for (auto i = 0; i < NumQueries; ++i)
+		{
+			FHitResult Hit;
+			PhysicsDistances[i] = World->LineTraceSingleByChannel(Hit, Starts[i], Ends[i], ECC_WorldStatic, Params) ? Hit.Distance : -1.f;
+		}
+		auto const PhysicsRayMs = (FPlatformTime::Seconds() - PhysicsRayStart) * 1000.0;
+
+		TArray<float> BVHDistances;
+		BVHDistances.SetNumUninitialized(NumQueries);
+		auto const BVHRayStart = FPlatformTime::Seconds();
+		for (auto i = 0; i < NumQueries; ++i)
+		{
+			FPhantoSceneBVHHit Hit;
+			BVHDistances[i] = BVH->Raycast(Starts[i], Ends[i], Hit) ? Hit.Distance : -1.f;
+		}
+		auto const BVHRayMs = (FPlatformTime::Seconds() - BVHRayStart) * 1000.0;
+
+		// Physics also sees actors that aren't part of the scene mesh, and collision shapes may differ slightly.
+		auto Agreeing = 0;
+		for (auto i = 0; i < NumQueries; ++i)
+		{
+			if ((PhysicsDistances[i] < 0) == (BVHDistances[i] < 0) && FMath::Abs(PhysicsDistances[i] - BVHDistances[i]) < 1.f)
+				++Agreeing;
+		}
+
+		auto PhysicsOverlaps = 0;
+		auto const PhysicsOverlapStart = FPlatformTime::Seconds();
+		for (auto i = 0; i < NumQueries; ++i)
+		{
+			PhysicsOverlaps += World->OverlapAnyTestByChannel(Starts[i], FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeSphere(Radius), Params);
+		}
+		auto const PhysicsOverlapMs = (FPlatformTime::Seconds() - PhysicsOverlapStart) * 1000.0;
+
+		auto BVHOverlaps = 0;
+		auto const BVHOverlapStart = FPlatformTime::Seconds();
+		for (auto i = 0; i < NumQueries; ++i)
+		{
+			BVHOverlaps += BVH->OverlapsSphere(Starts[i], Radius);
+		}
+		auto const BVHOverlapMs = (FPlatformTime::Seconds() - BVHOverlapStart) * 1000.0;
+
+		UE_LOG(LogPhanto, Display, TEXT("Scene BVH, %d triangles, %d queries: rays physics %.3f ms, BVH %.3f ms (%.1fx), %.1f%% agreeing; sphere overlaps physics %.3f ms (%d), BVH %.3f ms (%d) (%.1fx)"),
+			BVH->GetNumTriangles(), NumQueries,
+			PhysicsRayMs, BVHRayMs, BVHRayMs > 0 ? PhysicsRayMs / BVHRayMs : 0.0, NumQueries > 0 ? 100.0 * Agreeing / NumQueries : 0.0,
+			PhysicsOverlapMs, PhysicsOverlaps, BVHOverlapMs, BVHOverlaps, BVHOverlapMs > 0 ? PhysicsOverlapMs / BVHOverlapMs : 0.0);
+	}));
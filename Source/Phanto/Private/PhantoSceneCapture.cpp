@@ -0,0 +1,255 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoSceneCapture.h"
+
+#include "Async/MappedFileHandle.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OculusXRSceneActor.h"
+#include "OculusXRSceneAnchorComponent.h"
+#include "Phanto.h"
+#include "PhantoSceneGeometry.h"
+
+namespace
+{
+	uint64 Align16(uint64 Offset)
+	{
+		return Align(Offset, 16);
+	}
+
+	template <typename T>
+	bool IsSectionValid(uint64 Offset, uint64 Count, int64 Size)
+	{
+		return Offset % alignof(T) == 0 && Offset <= uint64(Size) && Count <= (uint64(Size) - Offset) / sizeof(T);
+	}
+
+	template <typename T>
+	void WriteSection(TArray64<uint8>& Buffer, uint64 Offset, TConstArrayView<T> Items)
+	{
+		if (Items.Num() > 0)
+			FMemory::Memcpy(Buffer.GetData() + Offset, Items.GetData(), Items.Num() * sizeof(T));
+	}
+}
+
+FTransform FPhantoSceneCaptureAnchor::GetTransform() const
+{
+	return FTransform(
+		FQuat(Rotation[0], Rotation[1], Rotation[2], Rotation[3]).GetNormalized(),
+		FVector(Location[0], Location[1], Location[2]));
+}
+
+FPhantoSceneCapture::~FPhantoSceneCapture()
+{
+	// The region must be unmapped before its file is closed.
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TUniquePtr<FPhantoSceneCapture> FPhantoSceneCapture::Open(const FString& Path)
+{
+	TUniquePtr<FPhantoSceneCapture> Capture(new FPhantoSceneCapture);
+
+	Capture->MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	if (Capture->MappedFile)
+		Capture->MappedRegion.Reset(Capture->MappedFile->MapRegion(0, Capture->MappedFile->GetFileSize()));
+
+	if (Capture->MappedRegion)
+	{
+		if (!Capture->Initialize(Capture->MappedRegion->GetMappedPtr(), Capture->MappedRegion->GetMappedSize()))
+			return nullptr;
+	}
+	else
+	{
+		Capture->MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Capture->Loaded, *Path))
+		{
+			UE_LOG(LogPhanto, Warning, TEXT("Scene capture %s couldn't be read"), *Path);
+			return nullptr;
+		}
+		if (!Capture->Initialize(Capture->Loaded.GetData(), Capture->Loaded.Num()))
+			return nullptr;
+	}
+	return Capture;
+}
+
+bool FPhantoSceneCapture::Initialize(const uint8* Data, int64 Size)
+{
+	if (!Data || Size < int64(sizeof(FPhantoSceneCaptureHeader)))
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("Scene capture is truncated"));
+		return false;
+	}
+
+	auto const& FileHeader = *reinterpret_cast<const FPhantoSceneCaptureHeader*>(Data);
+	if (FileHeader.Magic != FPhantoSceneCaptureHeader::ExpectedMagic || FileHeader.Version != FPhantoSceneCaptureHeader::CurrentVersion)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("Scene capture has an unknown format or version %u"), FileHeader.Version);
+		return false;
+	}
+
+	if (!IsSectionValid<FVector3f>(FileHeader.VerticesOffset, FileHeader.NumVertices, Size)
+		|| !IsSectionValid<uint32>(FileHeader.IndicesOffset, FileHeader.NumIndices, Size)
+		|| !IsSectionValid<FPhantoSceneCaptureAnchor>(FileHeader.AnchorsOffset, FileHeader.NumAnchors, Size)
+		|| !IsSectionValid<UTF8CHAR>(FileHeader.StringsOffset, FileHeader.NumStringBytes, Size)
+		|| FileHeader.NumIndices % 3 != 0)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("Scene capture sections are out of the file"));
+		return false;
+	}
+
+	Header = &FileHeader;
+	Vertices = MakeArrayView(reinterpret_cast<const FVector3f*>(Data + FileHeader.VerticesOffset), FileHeader.NumVertices);
+	Indices = MakeArrayView(reinterpret_cast<const uint32*>(Data + FileHeader.IndicesOffset), FileHeader.NumIndices);
+	Anchors = MakeArrayView(reinterpret_cast<const FPhantoSceneCaptureAnchor*>(Data + FileHeader.AnchorsOffset), FileHeader.NumAnchors);
+	Strings = MakeArrayView(reinterpret_cast<const UTF8CHAR*>(Data + FileHeader.StringsOffset), FileHeader.NumStringBytes);
+
+	// Ranges are checked once here so that readers can index the views without checks.
+	for (auto const& Anchor : Anchors)
+	{
+		if (uint64(Anchor.FirstVertex) + Anchor.NumVertices > FileHeader.NumVertices
+			|| uint64(Anchor.FirstIndex) + Anchor.NumIndices > FileHeader.NumIndices
+			|| uint64(Anchor.ClassificationsOffset) + Anchor.ClassificationsLength > FileHeader.NumStringBytes
+			|| Anchor.Label >= PhantoScene::NumSemanticLabels)
+		{
+			UE_LOG(LogPhanto, Warning, TEXT("Scene capture anchor ranges are out of the file"));
+			return false;
+		}
+
+		for (auto Index : Indices.Slice(int32(Anchor.FirstIndex), int32(Anchor.NumIndices)))
+		{
+			if (Index < Anchor.FirstVertex || Index - Anchor.FirstVertex >= Anchor.NumVertices)
+			{
+				UE_LOG(LogPhanto, Warning, TEXT("Scene capture index %u is out of its anchor vertices"), Index);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+TArray<FString> FPhantoSceneCapture::GetClassifications(const FPhantoSceneCaptureAnchor& Anchor) const
+{
+	TArray<FString> Classifications;
+	if (Anchor.ClassificationsLength == 0)
+		return Classifications;
+
+	auto const Joined = FString(int32(Anchor.ClassificationsLength), &Strings[Anchor.ClassificationsOffset]);
+	Joined.ParseIntoArray(Classifications, TEXT(","));
+	return Classifications;
+}
+
+bool PhantoSceneCapture::CaptureToFile(const TArray<AActor*>& Roots, const FString& Path)
+{
+	TArray<AActor*> Actors;
+	PhantoSceneGeometry::GatherSceneActors(Roots, Actors);
+
+	FPhantoSceneMeshData Mesh;
+	TArray<FPhantoSceneCaptureAnchor> Anchors;
+	TArray<UTF8CHAR> Strings;
+	for (auto Actor : Actors)
+	{
+		auto const FirstVertex = Mesh.Vertices.Num();
+		auto const FirstIndex = Mesh.Indices.Num();
+		Actor->ForEachComponent<UPrimitiveComponent>(false, [&Mesh](const UPrimitiveComponent* Component)
+		{
+			PhantoSceneGeometry::AppendComponentTriangles(*Component, Mesh);
+		});
+
+		auto AnchorComponent = Actor->FindComponentByClass<UOculusXRSceneAnchorComponent>();
+		if (!AnchorComponent && Mesh.Indices.Num() == FirstIndex)
+			continue;
+
+		FPhantoSceneCaptureAnchor Anchor = {};
+		auto const Transform = Actor->GetActorTransform();
+		auto const Location = FVector3f(Transform.GetLocation());
+		auto const Rotation = FQuat4f(Transform.GetRotation());
+		Anchor.Location[0] = Location.X;
+		Anchor.Location[1] = Location.Y;
+		Anchor.Location[2] = Location.Z;
+		Anchor.Rotation[0] = Rotation.X;
+		Anchor.Rotation[1] = Rotation.Y;
+		Anchor.Rotation[2] = Rotation.Z;
+		Anchor.Rotation[3] = Rotation.W;
+		Anchor.FirstVertex = uint32(FirstVertex);
+		Anchor.NumVertices = uint32(Mesh.Vertices.Num() - FirstVertex);
+		Anchor.FirstIndex = uint32(FirstIndex);
+		Anchor.NumIndices = uint32(Mesh.Indices.Num() - FirstIndex);
+
+		if (AnchorComponent)
+		{
+			auto const Joined = FString::Join(AnchorComponent->SemanticClassifications, TEXT(","));
+			FTCHARToUTF8 Utf8(*Joined);
+			Anchor.ClassificationsOffset = uint32(Strings.Num());
+			Anchor.ClassificationsLength = uint32(Utf8.Length());
+			Strings.Append(reinterpret_cast<const UTF8CHAR*>(Utf8.Get()), Utf8.Length());
+			Anchor.Label = uint8(PhantoScene::GetLabelFromClassifications(AnchorComponent->SemanticClassifications));
+		}
+		Anchors.Add(Anchor);
+	}
+
+	if (Anchors.Num() == 0)
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("CaptureToFile: no scene anchor to capture"));
+		return false;
+	}
+
+	FPhantoSceneCaptureHeader Header;
+	Header.NumVertices = uint32(Mesh.Vertices.Num());
+	Header.NumIndices = uint32(Mesh.Indices.Num());
+	Header.NumAnchors = uint32(Anchors.Num());
+	Header.NumStringBytes = uint32(Strings.Num());
+	Header.VerticesOffset = sizeof(FPhantoSceneCaptureHeader);
+	Header.IndicesOffset = Align16(Header.VerticesOffset + Header.NumVertices * sizeof(FVector3f));
+	Header.AnchorsOffset = Align16(Header.IndicesOffset + Header.NumIndices * sizeof(uint32));
+	Header.StringsOffset = Align16(Header.AnchorsOffset + Header.NumAnchors * sizeof(FPhantoSceneCaptureAnchor));
+
+	TArray64<uint8> Buffer;
+	Buffer.SetNumZeroed(Header.StringsOffset + Header.NumStringBytes);
+	FMemory::Memcpy(Buffer.GetData(), &Header, sizeof(Header));
+	WriteSection<FVector3f>(Buffer, Header.VerticesOffset, Mesh.Vertices);
+	WriteSection<uint32>(Buffer, Header.IndicesOffset, Mesh.Indices);
+	WriteSection<FPhantoSceneCaptureAnchor>(Buffer, Header.AnchorsOffset, Anchors);
+	WriteSection<UTF8CHAR>(Buffer, Header.StringsOffset, Strings);
+
+	if (!FFileHelper::SaveArrayToFile(Buffer, *Path))
+	{
+		UE_LOG(LogPhanto, Warning, TEXT("CaptureToFile: couldn't write %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogPhanto, Log, TEXT("Captured %d scene anchors and %d triangles to %s (%lld bytes)"),
+		Anchors.Num(), Mesh.GetNumTriangles(), *Path, Buffer.Num());
+	return true;
+}
+
+FString PhantoSceneCapture::MakeCapturePath(const FString& Prefix)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SceneCaptures"),
+		FString::Printf(TEXT("%s_%s.phsc"), *Prefix, *FDateTime::Now().ToString()));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CaptureSceneCommand(
+	TEXT("Phanto.CaptureScene"),
+	TEXT("Writes the populated scene to a capture file for APhantoReplaySceneActor. Usage: Phanto.CaptureScene [Path=Saved/SceneCaptures/Room_<date>.phsc]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](TArray<FString> const& Args, UWorld* World)
+	{
+		if (!World)
+			return;
+
+		TArray<AActor*> SceneActors;
+		for (TActorIterator<AOculusXRSceneActor> It(World); It; ++It)
+		{
+			SceneActors.Add(*It);
+		}
+
+		auto const Path = Args.Num() > 0 ? Args[0] : PhantoSceneCapture::MakeCapturePath();
+		if (PhantoSceneCapture::CaptureToFile(SceneActors, Path))
+			UE_LOG(LogPhanto, Display, TEXT("Scene captured to %s"), *FPaths::ConvertRelativePathToFull(Path));
+	}));
@@ -0,0 +1,173 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoSceneGeometry.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "EngineUtils.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "ProceduralMeshComponent.h"
+#include "StaticMeshResources.h"
+
+namespace
+{
+	void AppendTransformed(const FTransform& Transform, TConstArrayView<FVector> Vertices, TConstArrayView<int32> Indices, FPhantoSceneMeshData& Out)
+	{
+		auto const Base = uint32(Out.Vertices.Num());
+		for (auto const& Vertex : Vertices)
+		{
+			Out.Vertices.Add(FVector3f(Transform.TransformPosition(Vertex)));
+		}
+		for (auto Index : Indices)
+		{
+			Out.Indices.Add(Base + uint32(Index));
+		}
+	}
+
+	void AppendBox(const FTransform& Transform, const FVector& Extent, FPhantoSceneMeshData& Out)
+	{
+		static int32 const Indices[] = {
+			0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+			2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3 };
+
+		FVector Corners[8];
+		for (auto i = 0; i < 8; ++i)
+		{
+			Corners[i] = FVector(i & 4 ? Extent.X : -Extent.X, i & 2 ? Extent.Y : -Extent.Y, i & 1 ? Extent.Z : -Extent.Z);
+		}
+		AppendTransformed(Transform, Corners, Indices, Out);
+	}
+
+	void AppendStaticMesh(const UStaticMeshComponent& Component, FPhantoSceneMeshData& Out)
+	{
+		auto Mesh = Component.GetStaticMesh();
+		if (!Mesh)
+			return;
+
+		auto const& Transform = Component.GetComponentTransform();
+		auto RenderData = Mesh->GetRenderData();
+		if (Mesh->bAllowCPUAccess && RenderData && RenderData->LODResources.Num() > 0)
+		{
+			auto const& LOD = RenderData->LODResources[0];
+			auto const& Positions = LOD.VertexBuffers.PositionVertexBuffer;
+			auto const Base = uint32(Out.Vertices.Num());
+			for (uint32 i = 0; i < Positions.GetNumVertices(); ++i)
+			{
+				Out.Vertices.Add(FVector3f(Transform.TransformPosition(FVector(Positions.VertexPosition(i)))));
+			}
+			for (auto i = 0; i < LOD.IndexBuffer.GetNumIndices(); ++i)
+			{
+				Out.Indices.Add(Base + LOD.IndexBuffer.GetIndex(i));
+			}
+			return;
+		}
+
+		// Cooked meshes usually keep no CPU copy of their vertices, their simple collision is what the physics traces hit anyway.
+		auto BodySetup = Mesh->GetBodySetup();
+		if (!BodySetup)
+			return;
+
+		for (auto const& Box : BodySetup->AggGeom.BoxElems)
+		{
+			AppendBox(Box.GetTransform() * Transform, FVector(Box.X, Box.Y, Box.Z) * 0.5, Out);
+		}
+		for (auto const& Convex : BodySetup->AggGeom.ConvexElems)
+		{
+			AppendTransformed(Convex.GetTransform() * Transform, Convex.VertexData, Convex.IndexData, Out);
+		}
+	}
+
+	void AppendProceduralMesh(const UProceduralMeshComponent& Component, FPhantoSceneMeshData& Out)
+	{
+		auto const& Transform = Component.GetComponentTransform();
+		for (auto Section = 0; Section < Component.GetNumSections(); ++Section)
+		{
+			auto MeshSection = const_cast<UProceduralMeshComponent&>(Component).GetProcMeshSection(Section);
+			if (!MeshSection || !MeshSection->bEnableCollision)
+				continue;
+
+			auto const Base = uint32(Out.Vertices.Num());
+			for (auto const& Vertex : MeshSection->ProcVertexBuffer)
+			{
+				Out.Vertices.Add(FVector3f(Transform.TransformPosition(Vertex.Position)));
+			}
+			for (auto Index : MeshSection->ProcIndexBuffer)
+			{
+				Out.Indices.Add(Base + Index);
+			}
+		}
+	}
+}
+
+FBox FPhantoSceneMeshData::GetBounds() const
+{
+	FBox Bounds(ForceInit);
+	for (auto const& Vertex : Vertices)
+	{
+		Bounds += FVector(Vertex);
+	}
+	return Bounds;
+}
+
+void PhantoSceneGeometry::GatherSceneActors(const TArray<AActor*>& Roots, TArray<AActor*>& OutActors)
+{
+	TSet<AActor*> Gathered;
+	UWorld* World = nullptr;
+	for (auto Root : Roots)
+	{
+		if (!Root)
+			continue;
+
+		World = Root->GetWorld();
+		Gathered.Add(Root);
+
+		TArray<AActor*> Attached;
+		Root->GetAttachedActors(Attached, true, true);
+		Gathered.Append(Attached);
+	}
+
+	if (World)
+	{
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			for (auto Owner = It->GetOwner(); Owner; Owner = Owner->GetOwner())
+			{
+				if (Gathered.Contains(Owner))
+				{
+					Gathered.Add(*It);
+					break;
+				}
+			}
+		}
+	}
+
+	OutActors = Gathered.Array();
+}
+
+void PhantoSceneGeometry::AppendComponentTriangles(const UPrimitiveComponent& Component, FPhantoSceneMeshData& Out)
+{
+	if (!Component.IsRegistered() || !CollisionEnabledHasQuery(Component.GetCollisionEnabled()))
+		return;
+
+	if (auto ProceduralMesh = Cast<UProceduralMeshComponent>(&Component))
+		AppendProceduralMesh(*ProceduralMesh, Out);
+	else if (auto StaticMesh = Cast<UStaticMeshComponent>(&Component))
+		AppendStaticMesh(*StaticMesh, Out);
+}
+
+FPhantoSceneMeshData PhantoSceneGeometry::GatherTriangles(const TArray<AActor*>& Roots)
+{
+	TArray<AActor*> Actors;
+	GatherSceneActors(Roots, Actors);
+
+	FPhantoSceneMeshData Mesh;
+	for (auto Actor : Actors)
+	{
+		Actor->ForEachComponent<UPrimitiveComponent>(false, [&Mesh](const UPrimitiveComponent* Component)
+		{
+			AppendComponentTriangles(*Component, Mesh);
+		});
+	}
+	return Mesh;
+}
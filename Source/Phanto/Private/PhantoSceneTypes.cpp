@@ -0,0 +1,36 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoSceneTypes.h"
+
+EPhantoSemanticLabel PhantoScene::GetLabelFromClassifications(const TArray<FString>& Classifications)
+{
+	for (auto const& Classification : Classifications)
+	{
+		if (Classification == TEXT("FLOOR"))
+			return EPhantoSemanticLabel::Floor;
+		if (Classification == TEXT("CEILING"))
+			return EPhantoSemanticLabel::Ceiling;
+		if (Classification == TEXT("WALL_FACE") || Classification == TEXT("INVISIBLE_WALL_FACE"))
+			return EPhantoSemanticLabel::Wall;
+		if (Classification == TEXT("DOOR_FRAME"))
+			return EPhantoSemanticLabel::Door;
+		if (Classification == TEXT("WINDOW_FRAME"))
+			return EPhantoSemanticLabel::Window;
+		if (Classification == TEXT("TABLE") || Classification == TEXT("COUCH") || Classification == TEXT("BED")
+			|| Classification == TEXT("STORAGE") || Classification == TEXT("SCREEN") || Classification == TEXT("LAMP")
+			|| Classification == TEXT("PLANT") || Classification == TEXT("OTHER"))
+			return EPhantoSemanticLabel::Furniture;
+	}
+	return EPhantoSemanticLabel::Unknown;
+}
+
+EPhantoSemanticLabel PhantoScene::GetLabelFromNormal(const FVector& Normal)
+{
+	// About 45 degrees from horizontal.
+	if (Normal.Z > 0.7)
+		return EPhantoSemanticLabel::Floor;
+	if (Normal.Z < -0.7)
+		return EPhantoSemanticLabel::Ceiling;
+	return EPhantoSemanticLabel::Wall;
+}
@@ -0,0 +1,139 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoStreamCollisionComponent.h"
+
+#include "Engine/World.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+#include "Phanto.h"
+#include "PhantoGooSplatManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Stream Traces"), STAT_PhantoStreamTraces, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stream Traces Per Frame"), STAT_PhantoStreamTracesPerFrame, STATGROUP_Phanto);
+
+UPhantoStreamCollisionComponent::UPhantoStreamCollisionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+void UPhantoStreamCollisionComponent::SetStreaming(bool bInStreaming)
+{
+	if (bStreaming == bInStreaming)
+		return;
+
+	bStreaming = bInStreaming;
+	bHasHit = false;
+	Traces.Reset();
+	ArcPoints.Reset();
+	SetComponentTickEnabled(bStreaming);
+}
+
+bool UPhantoStreamCollisionComponent::GetLastHit(FHitResult& Hit) const
+{
+	if (!bHasHit)
+		return false;
+
+	Hit = LastHit;
+	return true;
+}
+
+void UPhantoStreamCollisionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	auto const StartTime = FPlatformTime::Seconds();
+	{
+		SCOPE_CYCLE_COUNTER(STAT_PhantoStreamTraces);
+		ReadTraces(DeltaTime);
+		IssueTraces();
+	}
+
+	Stats.TraceTimeMs = float((FPlatformTime::Seconds() - StartTime) * 1000);
+	Stats.TracesPerFrame = Traces.Num();
+	SET_DWORD_STAT(STAT_PhantoStreamTracesPerFrame, Traces.Num());
+
+	if (bHasHit)
+	{
+		++Stats.Hits;
+		if (CleanRadius > 0)
+		{
+			if (auto SplatManager = APhantoGooSplatManager::GetGooSplatManager(this))
+				SplatManager->CleanSplatsInSphere(LastHit.ImpactPoint, CleanRadius);
+		}
+
+		if (DamagePerSecond > 0 && LastHit.GetActor())
+		{
+			UGameplayStatics::ApplyDamage(LastHit.GetActor(), DamagePerSecond * DeltaTime, nullptr, GetOwner(),
+				DamageType ? *DamageType : UDamageType::StaticClass());
+		}
+
+		OnStreamHit.Broadcast(LastHit, DeltaTime);
+	}
+}
+
+void UPhantoStreamCollisionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetStreaming(false);
+	Super::EndPlay(EndPlayReason);
+}
+
+void UPhantoStreamCollisionComponent::ReadTraces(float DeltaSeconds)
+{
+	auto World = GetWorld();
+	bHasHit = false;
+
+	// Segments are in order along the arc, the first one blocked is where the stream lands.
+	for (auto const& Trace : Traces)
+	{
+		FTraceDatum Datum;
+		if (!World->QueryTraceData(Trace, Datum))
+			continue;
+
+		if (auto Hit = FHitResult::GetFirstBlockingHit(Datum.OutHits))
+		{
+			LastHit = *Hit;
+			bHasHit = true;
+			break;
+		}
+	}
+}
+
+void UPhantoStreamCollisionComponent::IssueTraces()
+{
+	auto World = GetWorld();
+	auto const Start = GetComponentLocation();
+	auto const Velocity = GetForwardVector() * LaunchSpeed;
+	auto const HalfGravity = FVector(0, 0, 0.5 * World->GetGravityZ() * GravityScale);
+	auto const Step = ArcDuration / NumSegments;
+
+	ArcPoints.SetNum(NumSegments + 1, EAllowShrinking::No);
+	for (auto i = 0; i <= NumSegments; ++i)
+	{
+		auto const Time = Step * i;
+		ArcPoints[i] = Start + Velocity * Time + HalfGravity * Time * Time;
+	}
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(PhantoStream), false, GetOwner());
+	Traces.SetNum(NumSegments, EAllowShrinking::No);
+	for (auto i = 0; i < NumSegments; ++i)
+	{
+		Traces[i] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, ArcPoints[i], ArcPoints[i + 1], TraceChannel, Params);
+	}
+
+	// The arc of this frame lands about where the last one did, so cut it there for the visuals.
+	if (bHasHit)
+	{
+		for (auto i = 1; i <= NumSegments; ++i)
+		{
+			if (FVector::DotProduct(LastHit.ImpactPoint - ArcPoints[i], ArcPoints[i] - ArcPoints[i - 1]) <= 0)
+			{
+				ArcPoints.SetNum(i + 1, EAllowShrinking::No);
+				ArcPoints[i] = LastHit.ImpactPoint;
+				break;
+			}
+		}
+	}
+}
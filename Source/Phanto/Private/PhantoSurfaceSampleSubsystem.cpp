@@ -0,0 +1,351 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoSurfaceSampleSubsystem.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "OculusXRSceneAnchorComponent.h"
+#include "Phanto.h"
+#include "PhantoSceneAnchorRegistry.h"
+#include "PhantoSceneGeometry.h"
+
+DECLARE_CYCLE_STAT(TEXT("Surface Samples Build"), STAT_PhantoSurfaceSamplesBuild, STATGROUP_Phanto);
+
+namespace PhantoSurfaceSamples
+{
+	struct FCandidate
+	{
+		FVector3f Location;
+		FVector3f Normal;
+		EPhantoSemanticLabel Label;
+	};
+
+	/** Random points on the triangles of Mesh, Density per cm² on average. */
+	void AddCandidates(const FPhantoSceneMeshData& Mesh, EPhantoSemanticLabel AnchorLabel, float Density, FRandomStream& Random, TArray<FCandidate>& OutCandidates)
+	{
+		for (auto Triangle = 0; Triangle < Mesh.GetNumTriangles(); ++Triangle)
+		{
+			auto const& A = Mesh.Vertices[Mesh.Indices[Triangle * 3]];
+			auto const E1 = Mesh.Vertices[Mesh.Indices[Triangle * 3 + 1]] - A;
+			auto const E2 = Mesh.Vertices[Mesh.Indices[Triangle * 3 + 2]] - A;
+			auto const Cross = FVector3f::CrossProduct(E1, E2);
+			auto const Area = Cross.Size() * 0.5f;
+			if (Area <= UE_KINDA_SMALL_NUMBER)
+				continue;
+
+			// The scene actor builds its meshes facing into the room.
+			auto const Normal = Cross / (Area * 2);
+			auto const Label = AnchorLabel != EPhantoSemanticLabel::Unknown ? AnchorLabel : PhantoScene::GetLabelFromNormal(FVector(Normal));
+
+			// Nothing spawns under furniture.
+			if (Label == EPhantoSemanticLabel::Furniture && Normal.Z < -0.7f)
+				continue;
+
+			auto const Expected = Area * Density;
+			auto const Count = FMath::FloorToInt32(Expected) + (Random.FRand() < FMath::Frac(Expected) ? 1 : 0);
+			for (auto i = 0; i < Count; ++i)
+			{
+				auto U = Random.FRand();
+				auto V = Random.FRand();
+				if (U + V > 1)
+				{
+					U = 1 - U;
+					V = 1 - V;
+				}
+				OutCandidates.Add({ A + E1 * U + E2 * V, Normal, Label });
+			}
+		}
+	}
+
+	void Shuffle(TArray<FCandidate>& Candidates, FRandomStream& Random)
+	{
+		for (auto i = Candidates.Num() - 1; i > 0; --i)
+		{
+			Candidates.Swap(i, Random.RandRange(0, i));
+		}
+	}
+}
+
+template <typename FunctorType>
+void UPhantoSurfaceSampleSubsystem::ForEachPointInRadius(const FVector& Origin, float Radius, FunctorType&& Visitor) const
+{
+	if (GridStarts.Num() == 0 || Radius < 0)
+		return;
+
+	auto const CellSize = double(FMath::Max(GridCellSize, 1.f));
+	auto const Min = FIntVector(
+		FMath::Max(FMath::FloorToInt((Origin.X - Radius - GridOrigin.X) / CellSize), 0),
+		FMath::Max(FMath::FloorToInt((Origin.Y - Radius - GridOrigin.Y) / CellSize), 0),
+		FMath::Max(FMath::FloorToInt((Origin.Z - Radius - GridOrigin.Z) / CellSize), 0));
+	auto const Max = FIntVector(
+		FMath::Min(FMath::FloorToInt((Origin.X + Radius - GridOrigin.X) / CellSize), GridSize.X - 1),
+		FMath::Min(FMath::FloorToInt((Origin.Y + Radius - GridOrigin.Y) / CellSize), GridSize.Y - 1),
+		FMath::Min(FMath::FloorToInt((Origin.Z + Radius - GridOrigin.Z) / CellSize), GridSize.Z - 1));
+
+	auto const RadiusSquared = double(Radius) * Radius;
+	auto const Origin3f = FVector3f(Origin);
+	for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			for (int32 X = Min.X; X <= Max.X; ++X)
+			{
+				auto const Cell = (Z * GridSize.Y + Y) * GridSize.X + X;
+				for (int32 Index = GridStarts[Cell]; Index < GridStarts[Cell + 1]; ++Index)
+				{
+					auto const Point = GridPoints[Index];
+					auto const DistanceSquared = double(FVector3f::DistSquared(Locations[Point], Origin3f));
+					if (DistanceSquared <= RadiusSquared)
+						Visitor(Point, DistanceSquared);
+				}
+			}
+		}
+	}
+}
+
+int32 UPhantoSurfaceSampleSubsystem::BuildFromActors(const TArray<AActor*>& Actors)
+{
+	using namespace PhantoSurfaceSamples;
+	SCOPE_CYCLE_COUNTER(STAT_PhantoSurfaceSamplesBuild);
+
+	Clear();
+
+	auto const Spacing = FMath::Max(SampleSpacing, 1.f);
+
+	// A few candidates per disk of the final spacing leaves few gaps after elimination.
+	auto const Density = 4.f / (Spacing * Spacing);
+	FRandomStream Random(Seed);
+
+	TArray<AActor*> SceneActors;
+	PhantoSceneGeometry::GatherSceneActors(Actors, SceneActors);
+
+	TArray<FCandidate> AnchorCandidates;
+	TArray<FCandidate> MeshCandidates;
+	FPhantoSceneMeshData Mesh;
+	auto Registry = GetWorld()->GetSubsystem<UPhantoSceneAnchorRegistry>();
+	for (auto Actor : SceneActors)
+	{
+		// Anchors of other component classes aren't in the registry.
+		auto Label = Registry ? Registry->GetActorLabel(Actor) : EPhantoSemanticLabel::Unknown;
+		auto Anchor = Actor->FindComponentByClass<UOculusXRSceneAnchorComponent>();
+		if (Label == EPhantoSemanticLabel::Unknown && Anchor)
+			Label = PhantoScene::GetLabelFromClassifications(Anchor->SemanticClassifications);
+
+		Mesh.Reset();
+		Actor->ForEachComponent<UPrimitiveComponent>(false, [&Mesh](const UPrimitiveComponent* Component)
+		{
+			PhantoSceneGeometry::AppendComponentTriangles(*Component, Mesh);
+		});
+		AddCandidates(Mesh, Label, Density, Random, Label != EPhantoSemanticLabel::Unknown ? AnchorCandidates : MeshCandidates);
+	}
+
+	Shuffle(AnchorCandidates, Random);
+	Shuffle(MeshCandidates, Random);
+
+	// Dart throwing on a grid of cells small enough to hold a single kept point.
+	auto const CellSize = Spacing / UE_SQRT_3;
+	auto const SpacingSquared = Spacing * Spacing;
+	TMap<FIntVector, int32> KeptCells;
+	TArray<FCandidate> Kept;
+	for (auto const Candidates : { &AnchorCandidates, &MeshCandidates })
+	{
+		for (auto const& Candidate : *Candidates)
+		{
+			auto const Cell = FIntVector(
+				FMath::FloorToInt32(Candidate.Location.X / CellSize),
+				FMath::FloorToInt32(Candidate.Location.Y / CellSize),
+				FMath::FloorToInt32(Candidate.Location.Z / CellSize));
+
+			auto bFree = true;
+			for (auto Z = -2; Z <= 2 && bFree; ++Z)
+			{
+				for (auto Y = -2; Y <= 2 && bFree; ++Y)
+				{
+					for (auto X = -2; X <= 2 && bFree; ++X)
+					{
+						auto Other = KeptCells.Find(Cell + FIntVector(X, Y, Z));
+						bFree = !Other || FVector3f::DistSquared(Kept[*Other].Location, Candidate.Location) >= SpacingSquared;
+					}
+				}
+			}
+
+			if (bFree)
+				KeptCells.Add(Cell, Kept.Add(Candidate));
+		}
+	}
+
+	// Counting sort by label.
+	int32 Counts[PhantoScene::NumSemanticLabels] = {};
+	for (auto const& Point : Kept)
+	{
+		++Counts[int32(Point.Label)];
+	}
+	auto Start = 0;
+	for (auto Label = 0; Label < PhantoScene::NumSemanticLabels; ++Label)
+	{
+		LabelRanges[Label] = FIntPoint(Start, Counts[Label]);
+		Start += Counts[Label];
+	}
+
+	Locations.SetNumUninitialized(Kept.Num());
+	Normals.SetNumUninitialized(Kept.Num());
+	Labels.SetNumUninitialized(Kept.Num());
+	int32 Next[PhantoScene::NumSemanticLabels];
+	for (auto Label = 0; Label < PhantoScene::NumSemanticLabels; ++Label)
+	{
+		Next[Label] = LabelRanges[Label].X;
+	}
+	for (auto const& Point : Kept)
+	{
+		auto const Index = Next[int32(Point.Label)]++;
+		Locations[Index] = Point.Location;
+		Normals[Index] = Point.Normal;
+		Labels[Index] = Point.Label;
+	}
+
+	BuildGrid();
+
+	UE_LOG(LogPhanto, Log, TEXT("Surface samples: %d points from %d candidates (%d floor, %d wall, %d ceiling, %d furniture)"),
+		Locations.Num(), AnchorCandidates.Num() + MeshCandidates.Num(),
+		LabelRanges[int32(EPhantoSemanticLabel::Floor)].Y, LabelRanges[int32(EPhantoSemanticLabel::Wall)].Y,
+		LabelRanges[int32(EPhantoSemanticLabel::Ceiling)].Y, LabelRanges[int32(EPhantoSemanticLabel::Furniture)].Y);
+	return Locations.Num();
+}
+
+void UPhantoSurfaceSampleSubsystem::BuildGrid()
+{
+	GridStarts.Reset();
+	GridPoints.Reset();
+	if (Locations.Num() == 0)
+		return;
+
+	FBox3f Bounds(ForceInit);
+	for (auto const& Location : Locations)
+	{
+		Bounds += Location;
+	}
+
+	auto const CellSize = double(FMath::Max(GridCellSize, 1.f));
+	GridOrigin = FVector(Bounds.Min);
+	GridSize = FIntVector(
+		FMath::FloorToInt(Bounds.GetSize().X / CellSize) + 1,
+		FMath::FloorToInt(Bounds.GetSize().Y / CellSize) + 1,
+		FMath::FloorToInt(Bounds.GetSize().Z / CellSize) + 1);
+
+	auto const GetCell = [this, CellSize](const FVector3f& Location)
+	{
+		auto const Offset = (FVector(Location) - GridOrigin) / CellSize;
+		auto const X = FMath::Clamp(FMath::FloorToInt(Offset.X), 0, GridSize.X - 1);
+		auto const Y = FMath::Clamp(FMath::FloorToInt(Offset.Y), 0, GridSize.Y - 1);
+		auto const Z = FMath::Clamp(FMath::FloorToInt(Offset.Z), 0, GridSize.Z - 1);
+		return (Z * GridSize.Y + Y) * GridSize.X + X;
+	};
+
+	GridStarts.SetNumZeroed(GridSize.X * GridSize.Y * GridSize.Z + 1);
+	for (auto const& Location : Locations)
+	{
+		++GridStarts[GetCell(Location) + 1];
+	}
+	for (auto Cell = 1; Cell < GridStarts.Num(); ++Cell)
+	{
+		GridStarts[Cell] += GridStarts[Cell - 1];
+	}
+
+	GridPoints.SetNumUninitialized(Locations.Num());
+	TArray<int32> Fill(GridStarts.GetData(), GridStarts.Num() - 1);
+	for (auto Point = 0; Point < Locations.Num(); ++Point)
+	{
+		GridPoints[Fill[GetCell(Locations[Point])]++] = Point;
+	}
+}
+
+void UPhantoSurfaceSampleSubsystem::Clear()
+{
+	Locations.Reset();
+	Normals.Reset();
+	Labels.Reset();
+	GridStarts.Reset();
+	GridPoints.Reset();
+	for (auto& Range : LabelRanges)
+	{
+		Range = FIntPoint::ZeroValue;
+	}
+}
+
+FIntPoint UPhantoSurfaceSampleSubsystem::GetRange(EPhantoSemanticLabel Label) const
+{
+	return Label == EPhantoSemanticLabel::Unknown ? FIntPoint(0, Locations.Num()) : LabelRanges[int32(Label)];
+}
+
+int32 UPhantoSurfaceSampleSubsystem::GetNumSurfacePoints(EPhantoSemanticLabel Label) const
+{
+	return GetRange(Label).Y;
+}
+
+bool UPhantoSurfaceSampleSubsystem::GetRandomSurfacePoint(EPhantoSemanticLabel Label, FVector& OutLocation, FVector& OutNormal) const
+{
+	auto const Range = GetRange(Label);
+	if (Range.Y == 0)
+		return false;
+
+	auto const Point = Range.X + FMath::RandHelper(Range.Y);
+	OutLocation = FVector(Locations[Point]);
+	OutNormal = FVector(Normals[Point]);
+	return true;
+}
+
+bool UPhantoSurfaceSampleSubsystem::FindSurfacePointAwayFrom(EPhantoSemanticLabel Label, const FVector& Origin, float MinDistance,
+	FVector& OutLocation, FVector& OutNormal) const
+{
+	auto const Range = GetRange(Label);
+	if (Range.Y == 0)
+		return false;
+
+	// Most of the room is usually far enough, a few random picks almost always find a point.
+	auto const MinDistanceSquared = FMath::Square(MinDistance);
+	auto const Origin3f = FVector3f(Origin);
+	auto Point = INDEX_NONE;
+	for (auto Attempt = 0; Attempt < 16 && Point == INDEX_NONE; ++Attempt)
+	{
+		auto const Candidate = Range.X + FMath::RandHelper(Range.Y);
+		if (FVector3f::DistSquared(Locations[Candidate], Origin3f) >= MinDistanceSquared)
+			Point = Candidate;
+	}
+
+	// Otherwise scan from a random point so the fallback isn't always the same.
+	auto const Offset = FMath::RandHelper(Range.Y);
+	for (auto i = 0; i < Range.Y && Point == INDEX_NONE; ++i)
+	{
+		auto const Candidate = Range.X + (Offset + i) % Range.Y;
+		if (FVector3f::DistSquared(Locations[Candidate], Origin3f) >= MinDistanceSquared)
+			Point = Candidate;
+	}
+
+	if (Point == INDEX_NONE)
+		return false;
+
+	OutLocation = FVector(Locations[Point]);
+	OutNormal = FVector(Normals[Point]);
+	return true;
+}
+
+bool UPhantoSurfaceSampleSubsystem::FindSurfacePointNear(EPhantoSemanticLabel Label, const FVector& Origin, float MaxDistance,
+	FVector& OutLocation, FVector& OutNormal) const
+{
+	auto Point = INDEX_NONE;
+	auto NumCandidates = 0;
+	ForEachPointInRadius(Origin, MaxDistance, [&](int32 Candidate, double DistanceSquared)
+	{
+		if ((Label == EPhantoSemanticLabel::Unknown || Labels[Candidate] == Label) && FMath::RandRange(0, NumCandidates++) == 0)
+			Point = Candidate;
+	});
+
+	if (Point == INDEX_NONE)
+		return false;
+
+	OutLocation = FVector(Locations[Point]);
+	OutNormal = FVector(Normals[Point]);
+	return true;
+}
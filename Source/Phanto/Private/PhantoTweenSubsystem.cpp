@@ -0,0 +1,331 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoTweenSubsystem.h"
+
+#include "Components/LightComponent.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Phanto.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tweens"), STAT_PhantoTweens, STATGROUP_Phanto);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Tweens"), STAT_PhantoActiveTweens, STATGROUP_Phanto);
+
+float PhantoTween::Ease(EPhantoTweenEasing Easing, float Alpha)
+{
+	switch (Easing)
+	{
+	case EPhantoTweenEasing::EaseIn:
+		return Alpha * Alpha * Alpha;
+	case EPhantoTweenEasing::EaseOut:
+		return 1 - FMath::Cube(1 - Alpha);
+	case EPhantoTweenEasing::EaseInOut:
+		return Alpha < 0.5f ? 4 * Alpha * Alpha * Alpha : 1 - FMath::Cube(2 - 2 * Alpha) * 0.5f;
+	case EPhantoTweenEasing::SinusoidalInOut:
+		return 0.5f - 0.5f * FMath::Cos(PI * Alpha);
+	default:
+		return Alpha;
+	}
+}
+
+namespace PhantoTween
+{
+	template <typename ComponentType>
+	ComponentType* GetTarget(const FPhantoTweenBinding& Binding)
+	{
+		return Cast<ComponentType>(Binding.Target.Get());
+	}
+}
+
+bool PhantoTween::Apply(const FPhantoTweenBinding& Binding, float Value)
+{
+	switch (Binding.Kind)
+	{
+	case EPhantoTweenTarget::MaterialParameter:
+		if (auto Material = GetTarget<UMaterialInstanceDynamic>(Binding))
+		{
+			Material->SetScalarParameterValue(Binding.Parameter, Value);
+			return true;
+		}
+		return false;
+	case EPhantoTweenTarget::LightIntensity:
+		if (auto Light = GetTarget<ULightComponent>(Binding))
+		{
+			Light->SetIntensity(Value);
+			return true;
+		}
+		return false;
+	default:
+		return false;
+	}
+}
+
+bool PhantoTween::Apply(const FPhantoTweenBinding& Binding, const FVector& Value)
+{
+	if (Binding.Kind == EPhantoTweenTarget::MaterialParameter)
+	{
+		auto Material = GetTarget<UMaterialInstanceDynamic>(Binding);
+		if (Material)
+			Material->SetVectorParameterValue(Binding.Parameter, FLinearColor(Value));
+		return Material != nullptr;
+	}
+
+	auto Component = GetTarget<USceneComponent>(Binding);
+	if (!Component)
+		return false;
+
+	switch (Binding.Kind)
+	{
+	case EPhantoTweenTarget::RelativeLocation:
+		Component->SetRelativeLocation(Value);
+		return true;
+	case EPhantoTweenTarget::WorldLocation:
+		Component->SetWorldLocation(Value);
+		return true;
+	case EPhantoTweenTarget::RelativeScale:
+		Component->SetRelativeScale3D(Value);
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool PhantoTween::Apply(const FPhantoTweenBinding& Binding, const FLinearColor& Value)
+{
+	switch (Binding.Kind)
+	{
+	case EPhantoTweenTarget::MaterialParameter:
+		if (auto Material = GetTarget<UMaterialInstanceDynamic>(Binding))
+		{
+			Material->SetVectorParameterValue(Binding.Parameter, Value);
+			return true;
+		}
+		return false;
+	case EPhantoTweenTarget::LightColor:
+		if (auto Light = GetTarget<ULightComponent>(Binding))
+		{
+			Light->SetLightColor(Value);
+			return true;
+		}
+		return false;
+	default:
+		return false;
+	}
+}
+
+bool PhantoTween::Apply(const FPhantoTweenBinding& Binding, const FQuat& Value)
+{
+	auto Component = GetTarget<USceneComponent>(Binding);
+	if (!Component || Binding.Kind != EPhantoTweenTarget::RelativeRotation)
+		return false;
+
+	Component->SetRelativeRotation(Value);
+	return true;
+}
+
+bool PhantoTween::Apply(const FPhantoTweenBinding& Binding, const FTransform& Value)
+{
+	auto Component = GetTarget<USceneComponent>(Binding);
+	if (!Component || Binding.Kind != EPhantoTweenTarget::RelativeTransform)
+		return false;
+
+	Component->SetRelativeTransform(Value);
+	return true;
+}
+
+UPhantoTweenSubsystem::UPhantoTweenSubsystem()
+	: Scalars(ScalarChannel)
+	, Vectors(VectorChannel)
+	, Colors(ColorChannel)
+	, Rotations(RotationChannel)
+	, Transforms(TransformChannel)
+{
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenLocation(USceneComponent* Component, FVector Target, float Duration, EPhantoTweenEasing Easing, bool bWorldSpace)
+{
+	if (!Component)
+		return FPhantoTweenHandle();
+
+	auto const Kind = bWorldSpace ? EPhantoTweenTarget::WorldLocation : EPhantoTweenTarget::RelativeLocation;
+	auto const Start = bWorldSpace ? Component->GetComponentLocation() : Component->GetRelativeLocation();
+	return Vectors.Add(Start, Target, Duration, Easing, { Component, NAME_None, Kind });
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenRotation(USceneComponent* Component, FRotator Target, float Duration, EPhantoTweenEasing Easing)
+{
+	if (!Component)
+		return FPhantoTweenHandle();
+
+	return Rotations.Add(Component->GetRelativeRotation().Quaternion(), Target.Quaternion(), Duration, Easing,
+		{ Component, NAME_None, EPhantoTweenTarget::RelativeRotation });
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenScale(USceneComponent* Component, FVector Target, float Duration, EPhantoTweenEasing Easing)
+{
+	if (!Component)
+		return FPhantoTweenHandle();
+
+	return Vectors.Add(Component->GetRelativeScale3D(), Target, Duration, Easing, { Component, NAME_None, EPhantoTweenTarget::RelativeScale });
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenTransform(USceneComponent* Component, FTransform Target, float Duration, EPhantoTweenEasing Easing)
+{
+	if (!Component)
+		return FPhantoTweenHandle();
+
+	return Transforms.Add(Component->GetRelativeTransform(), Target, Duration, Easing, { Component, NAME_None, EPhantoTweenTarget::RelativeTransform });
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenMaterialScalar(UMaterialInstanceDynamic* Material, FName Parameter, float Start, float End, float Duration, EPhantoTweenEasing Easing)
+{
+	if (!Material)
+		return FPhantoTweenHandle();
+
+	return Scalars.Add(Start, End, Duration, Easing, { Material, Parameter, EPhantoTweenTarget::MaterialParameter });
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenMaterialColor(UMaterialInstanceDynamic* Material, FName Parameter, FLinearColor Start, FLinearColor End, float Duration, EPhantoTweenEasing Easing)
+{
+	if (!Material)
+		return FPhantoTweenHandle();
+
+	return Colors.Add(Start, End, Duration, Easing, { Material, Parameter, EPhantoTweenTarget::MaterialParameter });
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenLightIntensity(ULightComponent* Light, float End, float Duration, EPhantoTweenEasing Easing)
+{
+	if (!Light)
+		return FPhantoTweenHandle();
+
+	return Scalars.Add(Light->Intensity, End, Duration, Easing, { Light, NAME_None, EPhantoTweenTarget::LightIntensity });
+}
+
+FPhantoTweenHandle UPhantoTweenSubsystem::TweenLightColor(ULightComponent* Light, FLinearColor End, float Duration, EPhantoTweenEasing Easing)
+{
+	if (!Light)
+		return FPhantoTweenHandle();
+
+	return Colors.Add(Light->GetLightColor(), End, Duration, Easing, { Light, NAME_None, EPhantoTweenTarget::LightColor });
+}
+
+void UPhantoTweenSubsystem::CancelTween(FPhantoTweenHandle& Handle)
+{
+	switch (Handle.Channel)
+	{
+	case ScalarChannel:
+		Scalars.Cancel(Handle);
+		break;
+	case VectorChannel:
+		Vectors.Cancel(Handle);
+		break;
+	case ColorChannel:
+		Colors.Cancel(Handle);
+		break;
+	case RotationChannel:
+		Rotations.Cancel(Handle);
+		break;
+	case TransformChannel:
+		Transforms.Cancel(Handle);
+		break;
+	}
+	Handle.Invalidate();
+}
+
+bool UPhantoTweenSubsystem::IsTweenActive(const FPhantoTweenHandle& Handle) const
+{
+	switch (Handle.Channel)
+	{
+	case ScalarChannel:
+		return Scalars.IsActive(Handle);
+	case VectorChannel:
+		return Vectors.IsActive(Handle);
+	case ColorChannel:
+		return Colors.IsActive(Handle);
+	case RotationChannel:
+		return Rotations.IsActive(Handle);
+	case TransformChannel:
+		return Transforms.IsActive(Handle);
+	default:
+		return false;
+	}
+}
+
+int32 UPhantoTweenSubsystem::GetNumActiveTweens() const
+{
+	return Scalars.Num() + Vectors.Num() + Colors.Num() + Rotations.Num() + Transforms.Num();
+}
+
+void UPhantoTweenSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_PhantoTweens);
+	Scalars.Advance(DeltaTime);
+	Vectors.Advance(DeltaTime);
+	Colors.Advance(DeltaTime);
+	Rotations.Advance(DeltaTime);
+	Transforms.Advance(DeltaTime);
+	SET_DWORD_STAT(STAT_PhantoActiveTweens, GetNumActiveTweens());
+}
+
+TStatId UPhantoTweenSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPhantoTweenSubsystem, STATGROUP_Tickables);
+}
+
+bool UPhantoTweenSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkTweensCommand(
+	TEXT("Phanto.Bench.Tweens"),
+	TEXT("Compares batched rotation tweens with building the quaternions on every update, as the timer based node did. Usage: Phanto.Bench.Tweens [NumTweens=1000] [NumFrames=90]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](TArray<FString> const& Args, UWorld* World)
+	{
+		auto const NumTweens = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000;
+		auto const NumFrames = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 90;
+		auto const DeltaTime = 1 / 90.f;
+		auto const Duration = NumFrames * DeltaTime;
+
+		FRandomStream Random(NumTweens);
+		TArray<FRotator> Starts, Targets;
+		for (int32 i = 0; i < NumTweens; ++i)
+		{
+			Starts.Add(FRotator(Random.FRandRange(-90, 90), Random.FRandRange(-180, 180), 0));
+			Targets.Add(FRotator(Random.FRandRange(-90, 90), Random.FRandRange(-180, 180), 0));
+		}
+
+		// Reference: per tween rotators converted to quaternions on every update.
+		FRotator Sink = FRotator::ZeroRotator;
+		auto const ReferenceStart = FPlatformTime::Seconds();
+		for (int32 Frame = 1; Frame <= NumFrames; ++Frame)
+		{
+			auto const Alpha = Frame * DeltaTime / Duration;
+			for (int32 i = 0; i < NumTweens; ++i)
+			{
+				Sink += FQuat::Slerp(FQuat(Starts[i]), FQuat(Targets[i]), Alpha).Rotator();
+			}
+		}
+		auto const ReferenceMs = (FPlatformTime::Seconds() - ReferenceStart) * 1000.0;
+
+		TPhantoTweenChannel<FQuat> Tweens(0);
+		for (int32 i = 0; i < NumTweens; ++i)
+		{
+			Tweens.Add(FQuat(Starts[i]), FQuat(Targets[i]), Duration, EPhantoTweenEasing::Linear, FPhantoTweenBinding(),
+				TPhantoTweenChannel<FQuat>::FCallback::CreateLambda([&Sink](const FQuat& Rotation, bool) { Sink += Rotation.Rotator(); }));
+		}
+
+		auto const BatchStart = FPlatformTime::Seconds();
+		for (int32 Frame = 1; Frame <= NumFrames; ++Frame)
+		{
+			Tweens.Advance(DeltaTime);
+		}
+		auto const BatchMs = (FPlatformTime::Seconds() - BatchStart) * 1000.0;
+
+		UE_LOG(LogPhanto, Display, TEXT("Rotation tweens, %d tweens over %d frames: per-update quaternions %.3f ms/frame, batched %.3f ms/frame (%.1fx) [%s]"),
+			NumTweens, NumFrames, ReferenceMs / NumFrames, BatchMs / NumFrames, BatchMs > 0 ? ReferenceMs / BatchMs : 0.0, *Sink.ToString());
+	}));
@@ -0,0 +1,196 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+
+#include "PhantoVectorMath.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Phanto.h"
+#include "PhantoBlueprintFunctionLibrary.h"
+
+namespace PhantoVectorMath
+{
+	/** Four vectors transposed into one register per axis. */
+	struct FBatch
+	{
+		VectorRegister4Float X;
+		VectorRegister4Float Y;
+		VectorRegister4Float Z;
+	};
+
+	/** Loads Count (at most 4) vectors relative to Origin, the missing lanes are zero. */
+	FORCEINLINE FBatch Load(const FVector* Vectors, int32 Count, const FVector& Origin = FVector::ZeroVector)
+	{
+		alignas(16) float X[4] = {};
+		alignas(16) float Y[4] = {};
+		alignas(16) float Z[4] = {};
+		for (int32 k = 0; k < Count; ++k)
+		{
+			X[k] = float(Vectors[k].X - Origin.X);
+			Y[k] = float(Vectors[k].Y - Origin.Y);
+			Z[k] = float(Vectors[k].Z - Origin.Z);
+		}
+		return { VectorLoadAligned(X), VectorLoadAligned(Y), VectorLoadAligned(Z) };
+	}
+
+	FORCEINLINE FBatch Splat(const FVector& Vector)
+	{
+		return { VectorSetFloat1(float(Vector.X)), VectorSetFloat1(float(Vector.Y)), VectorSetFloat1(float(Vector.Z)) };
+	}
+
+	FORCEINLINE VectorRegister4Float Dot(const FBatch& A, const FBatch& B)
+	{
+		return VectorMultiplyAdd(A.Z, B.Z, VectorMultiplyAdd(A.Y, B.Y, VectorMultiply(A.X, B.X)));
+	}
+
+	/** Cosines from dot products and products of squared lengths, clamped, and 1 where a vector is zero. */
+	FORCEINLINE VectorRegister4Float SafeCosine(const VectorRegister4Float& Dots, const VectorRegister4Float& LengthsSquared)
+	{
+		auto const Epsilon = VectorSetFloat1(UE_SMALL_NUMBER);
+		auto const One = VectorSetFloat1(1.f);
+		auto const Cosine = VectorMultiply(Dots, VectorReciprocalSqrt(VectorMax(LengthsSquared, Epsilon)));
+		auto const Clamped = VectorMin(VectorMax(Cosine, VectorSetFloat1(-1.f)), One);
+		return VectorSelect(VectorCompareGT(LengthsSquared, Epsilon), Clamped, One);
+	}
+
+	FORCEINLINE void Store(const VectorRegister4Float& Values, float* Out, int32 Count)
+	{
+		alignas(16) float Lanes[4];
+		VectorStoreAligned(Values, Lanes);
+		for (int32 k = 0; k < Count; ++k)
+		{
+			Out[k] = Lanes[k];
+		}
+	}
+}
+
+void PhantoVectorMath::AnglesBetween(TConstArrayView<FVector> A, TConstArrayView<FVector> B, TArrayView<float> OutRadians)
+{
+	check(A.Num() == B.Num() && OutRadians.Num() == A.Num());
+
+	for (int32 i = 0; i < A.Num(); i += 4)
+	{
+		auto const Count = FMath::Min(4, A.Num() - i);
+		auto const BatchA = Load(&A[i], Count);
+		auto const BatchB = Load(&B[i], Count);
+		auto const Cosine = SafeCosine(Dot(BatchA, BatchB), VectorMultiply(Dot(BatchA, BatchA), Dot(BatchB, BatchB)));
+		Store(VectorACos(Cosine), &OutRadians[i], Count);
+	}
+}
+
+void PhantoVectorMath::AnglesTo(const FVector& Direction, TConstArrayView<FVector> Vectors, TArrayView<float> OutRadians)
+{
+	check(OutRadians.Num() == Vectors.Num());
+
+	auto const BatchDirection = Splat(Direction);
+	auto const DirectionLengthSquared = VectorSetFloat1(float(Direction.SizeSquared()));
+	for (int32 i = 0; i < Vectors.Num(); i += 4)
+	{
+		auto const Count = FMath::Min(4, Vectors.Num() - i);
+		auto const Batch = Load(&Vectors[i], Count);
+		auto const Cosine = SafeCosine(Dot(Batch, BatchDirection), VectorMultiply(Dot(Batch, Batch), DirectionLengthSquared));
+		Store(VectorACos(Cosine), &OutRadians[i], Count);
+	}
+}
+
+int32 PhantoVectorMath::FindInCone(const FVector& Origin, const FVector& Direction, float HalfAngleRadians, float MaxDistance,
+	TConstArrayView<FVector> Locations, TArray<int32>& OutIndices)
+{
+	auto const Axis = Direction.GetSafeNormal();
+	if (Axis.IsZero())
+		return 0;
+
+	// Inside when Dot >= Cos * Length, compared as signed squares to avoid the square root.
+	auto const Cos = FMath::Cos(HalfAngleRadians);
+	auto const SignedCosSquared = VectorSetFloat1(Cos * FMath::Abs(Cos));
+	auto const MaxDistanceSquared = VectorSetFloat1(MaxDistance > 0 ? FMath::Square(MaxDistance) : UE_MAX_FLT);
+	auto const BatchAxis = Splat(Axis);
+
+	auto const NumBefore = OutIndices.Num();
+	for (int32 i = 0; i < Locations.Num(); i += 4)
+	{
+		auto const Count = FMath::Min(4, Locations.Num() - i);
+		auto const Batch = Load(&Locations[i], Count, Origin);
+		auto const Dots = Dot(Batch, BatchAxis);
+		auto const LengthsSquared = Dot(Batch, Batch);
+		auto const Inside = VectorBitwiseAnd(
+			VectorCompareGE(VectorMultiply(Dots, VectorAbs(Dots)), VectorMultiply(SignedCosSquared, LengthsSquared)),
+			VectorCompareLE(LengthsSquared, MaxDistanceSquared));
+
+		auto const Mask = VectorMaskBits(Inside);
+		for (int32 k = 0; k < Count; ++k)
+		{
+			if (Mask & (1 << k))
+				OutIndices.Add(i + k);
+		}
+	}
+	return OutIndices.Num() - NumBefore;
+}
+
+static FAutoConsoleCommand BenchmarkVectorMathCommand(
+	TEXT("Phanto.Bench.VectorMath"),
+	TEXT("Compares the batch angle and cone functions with per-pair scalar calls. Usage: Phanto.Bench.VectorMath [NumVectors=1024] [NumIterations=1000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](TArray<FString> const& Args)
+	{
+		auto const NumVectors = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1024;
+		auto const NumIterations = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000;
+
+		FRandomStream Random(NumVectors);
+		TArray<FVector> A, B;
+		for (int32 i = 0; i < NumVectors; ++i)
+		{
+			A.Add(Random.VRand() * Random.FRandRange(1, 500));
+			B.Add(Random.VRand() * Random.FRandRange(1, 500));
+		}
+
+		// The scalar path needs normalized inputs, as Blueprints have to do before calling Angle Between.
+		double Sink = 0;
+		auto const ScalarAnglesStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			for (int32 i = 0; i < NumVectors; ++i)
+			{
+				Sink += UPhantoBlueprintFunctionLibrary::AngleBetweenRadians(A[i].GetSafeNormal(), B[i].GetSafeNormal());
+			}
+		}
+		auto const ScalarAnglesMs = (FPlatformTime::Seconds() - ScalarAnglesStart) * 1000.0;
+
+		TArray<float> Angles;
+		Angles.SetNumUninitialized(NumVectors);
+		auto const BatchAnglesStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			PhantoVectorMath::AnglesBetween(A, B, Angles);
+			Sink += Angles[Iteration % NumVectors];
+		}
+		auto const BatchAnglesMs = (FPlatformTime::Seconds() - BatchAnglesStart) * 1000.0;
+
+		auto const HalfAngle = FMath::DegreesToRadians(30.f);
+		auto const Forward = FVector::ForwardVector;
+		TArray<int32> Indices;
+		auto const ScalarConeStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			Indices.Reset();
+			for (int32 i = 0; i < NumVectors; ++i)
+			{
+				if (UPhantoBlueprintFunctionLibrary::AngleBetweenRadians(Forward, A[i].GetSafeNormal()) <= HalfAngle)
+					Indices.Add(i);
+			}
+			Sink += Indices.Num();
+		}
+		auto const ScalarConeMs = (FPlatformTime::Seconds() - ScalarConeStart) * 1000.0;
+
+		auto const BatchConeStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			Indices.Reset();
+			Sink += PhantoVectorMath::FindInCone(FVector::ZeroVector, Forward, HalfAngle, 0, A, Indices);
+		}
+		auto const BatchConeMs = (FPlatformTime::Seconds() - BatchConeStart) * 1000.0;
+
+		UE_LOG(LogPhanto, Display, TEXT("Vector math, %d vectors x %d: angles scalar %.3f ms, batch %.3f ms (%.1fx); cone scalar %.3f ms, batch %.3f ms (%.1fx) [%f]"),
+			NumVectors, NumIterations,
+			ScalarAnglesMs, BatchAnglesMs, BatchAnglesMs > 0 ? ScalarAnglesMs / BatchAnglesMs : 0.0,
+			ScalarConeMs, BatchConeMs, BatchConeMs > 0 ? ScalarConeMs / BatchConeMs : 0.0,
+			Sink);
+	}));
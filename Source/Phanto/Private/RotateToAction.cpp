@@ -3,7 +3,9 @@
 
 #include "RotateToAction.h"
 
-URotateToAction* URotateToAction::RotateTo(UObject const * WorldContext, FRotator Start, FRotator Target, float Time)
+#include "Engine/World.h"
+
+URotateToAction* URotateToAction::RotateTo(UObject const * WorldContext, FRotator Start, FRotator Target, float Time, EPhantoTweenEasing Easing)
 {
 	auto const Node = NewObject<URotateToAction>();
 	if (Node)
@@ -12,7 +14,7 @@ URotateToAction* URotateToAction::RotateTo(UObject const * WorldContext, FRotato
 		Node->Start = Start;
 		Node->Target = Target;
 		Node->Time = Time;
-		Node->StartTime = WorldContext->GetWorld()->TimeSeconds;
+		Node->Easing = Easing;
 		Node->RegisterWithGameInstance(WorldContext);
 	}
 	return Node;
@@ -20,40 +22,43 @@ URotateToAction* URotateToAction::RotateTo(UObject const * WorldContext, FRotato
 
 void URotateToAction::Activate()
 {
-	if (WorldContext.IsValid())
+	auto World = WorldContext.IsValid() ? WorldContext->GetWorld() : nullptr;
+	auto Tweens = World ? World->GetSubsystem<UPhantoTweenSubsystem>() : nullptr;
+	if (!Tweens)
 	{
-		FTimerDelegate TimerDelegate;
-		TimerDelegate.BindWeakLambda(this, [this]
-			{
-				if (!WorldContext.IsValid())
-				{
-					Cancel();
-					return;
-				}
-				
-				auto const Alpha = WorldContext->GetWorld()->TimeSince(StartTime) / Time;
-
-				if (Alpha < 1)
-				{
-					FQuat AQuat(Start);
-					FQuat BQuat(Target);
-					FQuat Result = FQuat::Slerp(AQuat, BQuat, Alpha);
-					Tick.Broadcast(Result.Rotator());
-				}
-				else
-				{
-					Completed.Broadcast(Target);
-					GetTimerManager()->ClearTimer(TimerHandle);
-				}
-			});
-		GetTimerManager()->SetTimer(TimerHandle, TimerDelegate, 0.01f, true);
+		Cancel();
+		return;
 	}
+
+	auto OnUpdate = TPhantoTweenChannel<FQuat>::FCallback::CreateWeakLambda(this, [this](const FQuat& Rotation, bool bCompleted)
+		{
+			if (!bCompleted)
+			{
+				Tick.Broadcast(Rotation.Rotator());
+				return;
+			}
+
+			TweenHandle.Invalidate();
+			Completed.Broadcast(Target);
+			SetReadyToDestroy();
+		});
+	TweenHandle = Tweens->GetRotations().Add(FQuat(Start), FQuat(Target), Time, Easing, FPhantoTweenBinding(), MoveTemp(OnUpdate));
 }
 
 void URotateToAction::Cancel()
 {
-	if (auto TimerManager = GetTimerManager())
+	if (TweenHandle.IsValid())
 	{
-		TimerManager->ClearTimer(TimerHandle);
+		auto World = WorldContext.IsValid() ? WorldContext->GetWorld() : nullptr;
+		if (auto Tweens = World ? World->GetSubsystem<UPhantoTweenSubsystem>() : nullptr)
+			Tweens->CancelTween(TweenHandle);
+		TweenHandle.Invalidate();
 	}
+
+	Super::Cancel();
+}
+
+bool URotateToAction::IsActive() const
+{
+	return TweenHandle.IsValid();
 }
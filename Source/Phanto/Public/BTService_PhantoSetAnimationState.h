@@ -0,0 +1,79 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTService.h"
+#include "BTService_PhantoSetAnimationState.generated.h"
+
+class FNumericProperty;
+
+struct FBTPhantoAnimationStateMemory
+{
+	/** Anim instance or pawn holding the state property. */
+	TWeakObjectPtr<UObject> Target;
+	FNumericProperty* Property = nullptr;
+	int64 LastState = INDEX_NONE;
+
+	/** Whether the state was handed over to UPhantoAnimStateBridgeComponent. */
+	bool bBridged = false;
+};
+
+/**
+ * Native BTS_PhantoSetAnimationState and BTS_PhantomSetAnimationState: picks the animation state of the pawn from the
+ * blackboard and its movement, and writes it to an enum or integer property of its anim instance (or of the pawn)
+ * only when it changes. State values are the indices of the animation state enum of the creature.
+ *
+ * By default the service only sets up a UPhantoAnimStateBridgeComponent on the pawn when it becomes relevant, which
+ * updates the state from blackboard and movement events, and never ticks.
+ */
+UCLASS()
+class PHANTO_API UBTService_PhantoSetAnimationState : public UBTService
+{
+	GENERATED_BODY()
+
+public:
+	/** Property of the anim instance, or of the pawn when the anim instance has none, the state is written to. */
+	UPROPERTY(EditAnywhere, Category = "Animation")
+	FName AnimStateProperty = TEXT("AnimState");
+
+	/** Bool key set while attacking, e.g. by the attack task. */
+	UPROPERTY(EditAnywhere, Category = "Animation")
+	FBlackboardKeySelector AttackingKey;
+
+	/** Speed above which the pawn is moving. */
+	UPROPERTY(EditAnywhere, Category = "Animation", meta = (ClampMin = "0"))
+	float MovingSpeed = 10;
+
+	UPROPERTY(EditAnywhere, Category = "Animation|States")
+	uint8 IdleState = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Animation|States")
+	uint8 MovingState = 1;
+
+	UPROPERTY(EditAnywhere, Category = "Animation|States")
+	uint8 AttackingState = 2;
+
+	/** State while falling or jumping a nav link. */
+	UPROPERTY(EditAnywhere, Category = "Animation|States")
+	uint8 FallingState = 3;
+
+	/** Hands the state over to an event driven UPhantoAnimStateBridgeComponent instead of ticking. */
+	UPROPERTY(EditAnywhere, Category = "Animation")
+	bool bUseAnimStateBridge = true;
+
+	UBTService_PhantoSetAnimationState();
+
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+
+private:
+	uint8 GetAnimationState(UBehaviorTreeComponent& OwnerComp) const;
+};
@@ -0,0 +1,24 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "BTTask_PhantoFindRoamPoint.generated.h"
+
+/** Picks a precomputed roam point reachable from the controlled pawn and writes it to a vector key. */
+UCLASS()
+class PHANTO_API UBTTask_PhantoFindRoamPoint : public UBTTask_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Maximum distance from the pawn; 0 picks anywhere in the region of the pawn. */
+	UPROPERTY(EditAnywhere, Category = "Roaming", meta = (ClampMin = "0"))
+	float Radius = 500;
+
+	UBTTask_PhantoFindRoamPoint();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual FString GetStaticDescription() const override;
+};
@@ -0,0 +1,42 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AITypes.h"
+#include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "NavigationData.h"
+#include "BTTask_PhantoMoveTo.generated.h"
+
+struct FBTPhantoMoveToMemory
+{
+	/** Pending request on the path request subsystem, 0 once the path arrived. */
+	uint32 PathRequestId = 0;
+	FAIRequestID MoveRequestId;
+};
+
+/**
+ * Moves to a blackboard location or actor with a path found through UPhantoPathRequestSubsystem, instead of the
+ * synchronous path finding of Move To. Not instanced, per agent state lives in node memory.
+ */
+UCLASS()
+class PHANTO_API UBTTask_PhantoMoveTo : public UBTTask_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Node", meta = (ClampMin = "0"))
+	float AcceptableRadius = 50;
+
+	UBTTask_PhantoMoveTo();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+private:
+	void HandlePathFound(uint32 RequestId, FNavPathSharedPtr Path, TWeakObjectPtr<UBehaviorTreeComponent> WeakOwnerComp);
+};
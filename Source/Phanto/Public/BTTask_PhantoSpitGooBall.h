@@ -0,0 +1,53 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "BTTask_PhantoSpitGooBall.generated.h"
+
+struct FBTPhantoSpitGooBallMemory
+{
+	float ElapsedTime = 0;
+	bool bFired = false;
+};
+
+/**
+ * Native BTT_PhantoSpitGooBall: faces the blackboard target (actor or location) and spits a goo ball at it through
+ * APhantoProjectileManager. Not instanced, per agent state lives in node memory.
+ */
+UCLASS()
+class PHANTO_API UBTTask_PhantoSpitGooBall : public UBTTask_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Socket of the pawn's skeletal mesh the goo ball leaves from, the pawn location when missing. */
+	UPROPERTY(EditAnywhere, Category = "Goo")
+	FName MouthSocket = TEXT("Mouth");
+
+	UPROPERTY(EditAnywhere, Category = "Goo", meta = (ClampMin = "1"))
+	float LaunchSpeed = 400;
+
+	/** Time from the start of the task to the spit, matching the animation. */
+	UPROPERTY(EditAnywhere, Category = "Goo", meta = (ClampMin = "0"))
+	float SpitDelay = 0.3f;
+
+	/** Total time of the task, it succeeds after it. */
+	UPROPERTY(EditAnywhere, Category = "Goo", meta = (ClampMin = "0"))
+	float Duration = 0.8f;
+
+	UBTTask_PhantoSpitGooBall();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+private:
+	/** Fires the goo ball. Returns false if there was no target or the projectile budget is spent. */
+	bool Spit(UBehaviorTreeComponent& OwnerComp) const;
+};
@@ -0,0 +1,63 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "Templates/SubclassOf.h"
+#include "BTTask_PhantomAttack.generated.h"
+
+class UDamageType;
+
+struct FBTPhantomAttackMemory
+{
+	float ElapsedTime = 0;
+	bool bDamageApplied = false;
+};
+
+/**
+ * Native BTT_PhantomAttack: faces the target actor of the blackboard key and damages it once the attack lands, if
+ * it's still in range. Not instanced, per agent state lives in node memory.
+ */
+UCLASS()
+class PHANTO_API UBTTask_PhantomAttack : public UBTTask_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Distance between the pawn and the target for the attack to start and to land. */
+	UPROPERTY(EditAnywhere, Category = "Attack", meta = (ClampMin = "0"))
+	float AttackRange = 60;
+
+	/** Time from the start of the attack to the hit, matching the attack animation. */
+	UPROPERTY(EditAnywhere, Category = "Attack", meta = (ClampMin = "0"))
+	float HitDelay = 0.4f;
+
+	/** Total time of the attack, the task succeeds after it. */
+	UPROPERTY(EditAnywhere, Category = "Attack", meta = (ClampMin = "0"))
+	float Duration = 1;
+
+	UPROPERTY(EditAnywhere, Category = "Attack")
+	float Damage = 10;
+
+	UPROPERTY(EditAnywhere, Category = "Attack")
+	TSubclassOf<UDamageType> DamageType;
+
+	/** Optional bool key set for the duration of the attack, read by Phanto Set Animation State. */
+	UPROPERTY(EditAnywhere, Category = "Attack")
+	FBlackboardKeySelector AttackingKey;
+
+	UBTTask_PhantomAttack();
+
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+private:
+	AActor* GetTargetInRange(UBehaviorTreeComponent& OwnerComp) const;
+};
@@ -0,0 +1,27 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BTTask_PhantoMoveTo.h"
+#include "BTTask_PhantomRoam.generated.h"
+
+/**
+ * Native BTT_PhantomRoam: picks a reachable roam point around the pawn, writes it to the blackboard key and moves
+ * there like Phanto Move To.
+ */
+UCLASS()
+class PHANTO_API UBTTask_PhantomRoam : public UBTTask_PhantoMoveTo
+{
+	GENERATED_BODY()
+
+public:
+	/** Maximum distance from the pawn; 0 picks anywhere in the region of the pawn. */
+	UPROPERTY(EditAnywhere, Category = "Roaming", meta = (ClampMin = "0"))
+	float Radius = 500;
+
+	UBTTask_PhantomRoam();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual FString GetStaticDescription() const override;
+};
@@ -6,9 +6,25 @@
 #include "OculusXRSceneAnchorComponent.h"
 #include "BlueprintXRSceneAnchorComponent.generated.h"
 
+/**
+ * Scene anchor that keeps its row of UPhantoSceneAnchorRegistry up to date while it's in play.
+ */
 UCLASS(BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
 class PHANTO_API UBlueprintXRSceneAnchorComponent : public UOculusXRSceneAnchorComponent
 {
 	GENERATED_BODY()
-	
+
+public:
+	/** Recomputes the cached registry data, e.g. after changing the semantic classifications. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Anchors")
+	void RefreshRegistration();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	FDelegateHandle TransformUpdatedHandle;
+
+	void HandleTransformUpdated(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport);
 };
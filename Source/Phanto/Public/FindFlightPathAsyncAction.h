@@ -0,0 +1,36 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "FindFlightPathAsyncAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FFindFlightPathOutputPin, const TArray<FVector>&, Path);
+
+/** Searches a path through the flight octree on a worker thread. */
+UCLASS()
+class PHANTO_API UFindFlightPathAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+	TWeakObjectPtr<UObject const> WorldContext;
+	FVector Start;
+	FVector End;
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FFindFlightPathOutputPin Found;
+
+	/** Also triggered when the flight octree has not been built. */
+	UPROPERTY(BlueprintAssignable)
+	FFindFlightPathOutputPin Failed;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContext"), Category = "AI|Flight Navigation")
+	static UFindFlightPathAsyncAction* FindFlightPath(UObject const * WorldContext, FVector Start, FVector End);
+
+	virtual void Activate() override;
+
+private:
+	void Finish(bool bFound, const TArray<FVector>& Path);
+};
@@ -0,0 +1,196 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoAILODSubsystem.generated.h"
+
+class AController;
+class APawn;
+class UBehaviorTreeComponent;
+class UDamageType;
+class UPathFollowingComponent;
+
+/** How much of its AI an enemy runs at full rate, from High, everything, to Low. */
+UENUM(BlueprintType)
+enum class EPhantoAILODTier : uint8
+{
+	High,
+	Medium,
+	Low,
+};
+
+/** Update intervals of a tier in seconds, 0 updates every frame. */
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoAILODTierSettings
+{
+	GENERATED_BODY()
+
+	/**
+	 * Least time between behavior tree ticks. Earlier ticks the tree asks for, e.g. when a task finishes or a blackboard
+	 * key changes, wait for it as well, so keep it short enough for the pawns' reactions.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0"))
+	float BehaviorTreeInterval = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0"))
+	float PathFollowingInterval = 0;
+
+	/** Tick interval of the skeletal meshes, which update their animation when they tick. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0"))
+	float AnimationInterval = 0;
+};
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoAILODStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "AI|LOD")
+	int32 NumHigh = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "AI|LOD")
+	int32 NumMedium = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "AI|LOD")
+	int32 NumLow = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "AI|LOD")
+	int32 Promotions = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "AI|LOD")
+	int32 Demotions = 0;
+};
+
+/**
+ * Throttles the AI of enemies the player isn't looking at or is far from. Registered pawns are classified a few times
+ * per second into tiers:
+ *
+ *   - High: hit in the last InteractionTime seconds, or in view closer than HighDistance.
+ *   - Medium: in view further away, or out of view closer than MediumDistance.
+ *   - Low: out of view and further away.
+ *
+ * Each tier sets the behavior tree, path following and skeletal mesh update intervals of its pawns. Distances and the
+ * view angle get a margin for pawns already on their near side, and a pawn stays at least MinTierTime in a tier before
+ * dropping to a lower one, so pawns on a boundary don't flip every update.
+ *
+ * Pawns possessed by an AI controller register themselves when spawned. Without a player camera, e.g. in the bench
+ * commandlet, the view can be set with SetViewOverride; without either, every pawn is High.
+ */
+UCLASS()
+class PHANTO_API UPhantoAILODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPhantoAILODSubsystem();
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD")
+	bool bEnabled = true;
+
+	/** Settings of each tier, by EPhantoAILODTier. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD")
+	TArray<FPhantoAILODTierSettings> TierSettings;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0"))
+	float UpdateInterval = 0.2f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0"))
+	float HighDistance = 400;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0"))
+	float MediumDistance = 200;
+
+	/** Half angle of the view cone in degrees, a bit wider than the headset's field of view. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0", ClampMax = "180"))
+	float ViewHalfAngle = 60;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD", meta = (ClampMin = "0"))
+	float InteractionTime = 3;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD|Hysteresis", meta = (ClampMin = "0"))
+	float DistanceMargin = 50;
+
+	/** In degrees. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD|Hysteresis", meta = (ClampMin = "0"))
+	float AngleMargin = 10;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|LOD|Hysteresis", meta = (ClampMin = "0"))
+	float MinTierTime = 1;
+
+	UFUNCTION(BlueprintCallable, Category = "AI|LOD")
+	void RegisterAgent(APawn* Pawn);
+
+	/** Restores the update intervals of Pawn to High. */
+	UFUNCTION(BlueprintCallable, Category = "AI|LOD")
+	void UnregisterAgent(APawn* Pawn);
+
+	/** Raises Pawn to High for InteractionTime. Taking damage counts already. */
+	UFUNCTION(BlueprintCallable, Category = "AI|LOD")
+	void NotifyInteraction(APawn* Pawn);
+
+	UFUNCTION(BlueprintPure, Category = "AI|LOD")
+	EPhantoAILODTier GetTier(const APawn* Pawn) const;
+
+	/** Classifies from this view instead of the player camera. */
+	UFUNCTION(BlueprintCallable, Category = "AI|LOD")
+	void SetViewOverride(const FVector& Location, const FVector& Direction);
+
+	UFUNCTION(BlueprintCallable, Category = "AI|LOD")
+	void ClearViewOverride() { bHasViewOverride = false; }
+
+	UFUNCTION(BlueprintPure, Category = "AI|LOD")
+	FPhantoAILODStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "AI|LOD")
+	void ResetStats();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FAgent
+	{
+		TWeakObjectPtr<APawn> Pawn;
+		TWeakObjectPtr<UBehaviorTreeComponent> BehaviorTree;
+		TWeakObjectPtr<UPathFollowingComponent> PathFollowing;
+		EPhantoAILODTier Tier = EPhantoAILODTier::High;
+		bool bInView = true;
+		double TierTime = 0;
+		double InteractionTime = -UE_BIG_NUMBER;
+	};
+
+	TArray<FAgent> Agents;
+	FPhantoAILODStats Stats;
+	double NextUpdateTime = 0;
+
+	FVector ViewOverrideLocation = FVector::ZeroVector;
+	FVector ViewOverrideDirection = FVector::ForwardVector;
+	bool bHasViewOverride = false;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	/** Scratch for the batched view cone test. */
+	TArray<FVector> Locations;
+	TArray<int32> ConeIndices;
+	TArray<uint8> ViewStates;
+
+	bool GetView(FVector& OutLocation, FVector& OutDirection) const;
+	void Classify(double Time);
+	EPhantoAILODTier GetDesiredTier(const FAgent& Agent, double DistanceSquared, double Time) const;
+	const FPhantoAILODTierSettings& GetSettings(EPhantoAILODTier Tier) const;
+	static bool ResolveComponents(FAgent& Agent);
+	void ApplyTier(const FAgent& Agent, EPhantoAILODTier Tier) const;
+	void ThrottleBehaviorTrees();
+
+	void HandleActorSpawned(AActor* Actor);
+
+	UFUNCTION()
+	void HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+};
@@ -0,0 +1,108 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "PhantoActorPoolSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoActorPoolStats
+{
+	GENERATED_BODY()
+
+	/** Acquisitions served from the pool, each one a spawn avoided. */
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Hits = 0;
+
+	/** Acquisitions that had to spawn an actor. */
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Misses = 0;
+
+	/** Releases kept in the pool, each one a destroy avoided. */
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 DestroysAvoided = 0;
+
+	/** Releases destroyed because the pool was over its limit. */
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Discarded = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Prewarmed = 0;
+
+	/** Actors acquired and not released yet. */
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 InUse = 0;
+
+	/** Most actors in use at once. */
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 HighWaterMark = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Pooled = 0;
+};
+
+USTRUCT()
+struct FPhantoActorPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> Free;
+
+	FPhantoActorPoolStats Stats;
+};
+
+/**
+ * Per-class pools of actors, to recycle enemies and effects instead of spawning and destroying them every wave.
+ *
+ * Released actors are hidden, stop colliding and ticking, and their AI and movement are stopped; actors implementing
+ * IPhantoPoolable are notified to reset the rest. Acquired actors and their components are back to the tick and
+ * activation state they were spawned in; ticks turned on at runtime are for OnAcquiredFromPool to restore. A pool
+ * keeps as many actors as were prewarmed or ever in use at once (its high-water mark), up to MaxPooledPerClass, and
+ * destroys releases beyond that.
+ */
+UCLASS()
+class PHANTO_API UPhantoActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadWrite, Category = "Pool")
+	int32 MaxPooledPerClass = 32;
+
+	/** Spawns actors of Class until Count of them are pooled, e.g. during the lobby. */
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	void Prewarm(TSubclassOf<AActor> Class, int32 Count);
+
+	/** Takes an actor of Class out of the pool, or spawns one when the pool is empty. */
+	UFUNCTION(BlueprintCallable, Category = "Pool", meta = (DeterminesOutputType = "Class"))
+	AActor* Acquire(TSubclassOf<AActor> Class, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr);
+
+	/** Returns an actor to the pool of its class, or destroys it if the pool is full. */
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	void Release(AActor* Actor);
+
+	/** Destroys the pooled actors of every class. */
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	void EmptyPools();
+
+	UFUNCTION(BlueprintPure, Category = "Pool")
+	FPhantoActorPoolStats GetPoolStats(TSubclassOf<AActor> Class) const;
+
+	/** Stats summed over every class. */
+	UFUNCTION(BlueprintPure, Category = "Pool")
+	FPhantoActorPoolStats GetTotalStats() const;
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+private:
+	UPROPERTY()
+	TMap<TSubclassOf<AActor>, FPhantoActorPool> Pools;
+
+	AActor* Spawn(TSubclassOf<AActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator) const;
+	void Deactivate(AActor* Actor) const;
+	void Activate(AActor* Actor, const FTransform& Transform) const;
+};
@@ -0,0 +1,120 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "PhantoAnimStateBridgeComponent.generated.h"
+
+class ACharacter;
+class AController;
+class APawn;
+class FNumericProperty;
+
+/** Animation state to use while a bool blackboard key is set. */
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoAnimStateKey
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	FName Key;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	uint8 State = 0;
+};
+
+/**
+ * Keeps the animation state of a pawn (PhantoAnimStates, PhantomAnimStates) in sync from events instead of a ticking
+ * service: blackboard observers on the state keys, and movement mode and speed changes of characters. The state is
+ * derived again on those events only and written to the anim instance only when it changes.
+ *
+ * Pawns that aren't characters have no movement events; their speed is polled every MovementPollInterval instead,
+ * and only when moving has a state of its own.
+ */
+UCLASS(ClassGroup = (AI), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
+class PHANTO_API UPhantoAnimStateBridgeComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPhantoAnimStateBridgeComponent();
+
+	/** Property of the anim instance, or of the pawn when the anim instance has none, the state is written to. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	FName AnimStateProperty = TEXT("AnimState");
+
+	/** States of the bool blackboard keys, the first key set wins over movement. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	TArray<FPhantoAnimStateKey> KeyStates;
+
+	/** Speed above which the pawn is moving. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation", meta = (ClampMin = "0"))
+	float MovingSpeed = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation|States")
+	uint8 IdleState = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation|States")
+	uint8 MovingState = 1;
+
+	/** State while falling or jumping a nav link. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation|States")
+	uint8 FallingState = 3;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation", meta = (ClampMin = "0"))
+	float MovementPollInterval = 0.1f;
+
+	/** Observes the state keys of Blackboard, replacing the previous one. The controller's is used by default. */
+	UFUNCTION(BlueprintCallable, Category = "Animation")
+	void SetBlackboard(UBlackboardComponent* Blackboard);
+
+	/** Derives the state again and writes it if it changed. */
+	UFUNCTION(BlueprintCallable, Category = "Animation")
+	void RefreshState();
+
+	UFUNCTION(BlueprintPure, Category = "Animation")
+	uint8 GetAnimState() const { return CurrentState; }
+
+	/** Number of times the state was written, for profiling. */
+	int32 GetNumWrites() const { return NumWrites; }
+
+	/** Integer or enum property Name of Object, null if it has none. */
+	static FNumericProperty* FindAnimStateProperty(const UObject& Object, FName Name);
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	TWeakObjectPtr<UBlackboardComponent> ObservedBlackboard;
+	TArray<FBlackboard::FKey, TInlineAllocator<4>> KeyIds;
+
+	TWeakObjectPtr<UObject> StateTarget;
+	FNumericProperty* StateProperty = nullptr;
+
+	uint8 CurrentState = 0;
+	bool bHasWrittenState = false;
+	bool bWasMoving = false;
+	int32 NumWrites = 0;
+
+	APawn* GetPawn() const;
+	bool IsMoving() const;
+	uint8 DeriveState() const;
+	bool ResolveStateProperty();
+
+	EBlackboardNotificationResult HandleKeyChanged(const UBlackboardComponent& Blackboard, FBlackboard::FKey Key);
+
+	UFUNCTION()
+	void HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
+	UFUNCTION()
+	void HandleMovementModeChanged(ACharacter* Character, EMovementMode PreviousMovementMode, uint8 PreviousCustomMode);
+
+	UFUNCTION()
+	void HandleMovementUpdated(float DeltaSeconds, FVector OldLocation, FVector OldVelocity);
+};
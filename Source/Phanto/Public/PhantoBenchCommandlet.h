@@ -0,0 +1,55 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Templates/SubclassOf.h"
+#include "PhantoBenchCommandlet.generated.h"
+
+class APawn;
+class FJsonObject;
+class UBehaviorTree;
+
+/**
+ * Headless gameplay benchmark, run with NullRHI on a Win64 machine without a headset (the OculusXR plugins the module
+ * depends on aren't available on Linux or Mac):
+ *
+ *   UnrealEditor-Cmd.exe Phanto.uproject -run=PhantoBench -nullrhi -unattended -Room=<capture.phsc>
+ *     [-Map=/Game/Phanto/Maps/GameScene] [-Seconds=30] [-Fps=72] [-Phantoms=8,32,128]
+ *     [-PhantomClass=/Game/Phanto/Enemies/Phantom/BP_Phantom.BP_Phantom_C] [-BehaviorTree=<tree>] [-AILOD]
+ *     [-Output=<report.json>]
+ *
+ * Loads the map and the recorded room, then runs scene population, nav build, nav link generation and a wave of
+ * Phantoms per count at a fixed timestep. BehaviorTree replaces the tree of the Phantoms, to compare Blueprint and
+ * native nodes. AILOD throttles the Phantoms by AI level of detail, viewed from a random spot in the room, and adds
+ * their tiers to each wave. Timings, subsystem stats and memory high-water marks of every phase are written as JSON,
+ * under Saved/Bench by default.
+ */
+UCLASS()
+class PHANTO_API UPhantoBenchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPhantoBenchCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	float DeltaSeconds = 1.f / 72;
+	uint64 PeakUsedPhysical = 0;
+
+	/** Ticks World once at the fixed timestep. Returns the time it took in ms. */
+	double TickWorld(UWorld& World);
+
+	/** Ticks World until Predicate returns false or MaxFrames. Returns the number of frames ticked. */
+	int32 TickWhile(UWorld& World, int32 MaxFrames, TFunctionRef<bool()> Predicate);
+
+	/** Runs NumPhantoms Phantoms for Seconds and adds their phase to Phases. Returns the average frame time. */
+	double RunWave(UWorld& World, FJsonObject& Phases, const FString& Name, TSubclassOf<APawn> PhantomClass,
+		int32 NumPhantoms, UBehaviorTree* BehaviorTree, float Seconds, double BaselineMs = 0);
+
+	/** Adds a phase to Report with its duration and the memory high-water mark so far. */
+	TSharedRef<FJsonObject> AddPhase(FJsonObject& Report, const FString& Name, double StartTime);
+};
@@ -10,8 +10,12 @@
 #include "Misc/Optional.h"
 #include "Navigation/PathFollowingComponent.h"
 #include "OculusXRSceneActor.h"
+#include "PhantoNavLinkSetOptimizer.h"
 #include "PhantoBlueprintFunctionLibrary.generated.h"
 
+class ANavigationData;
+class APhantoReplaySceneActor;
+
 UCLASS()
 class PHANTO_API UPopulateSceneAsyncAction : public UBlueprintAsyncActionBase
 {
@@ -31,6 +35,75 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "OculusXR|Scene Actor", meta = (BlueprintInternalUseOnly = "true"))
 	static UPopulateSceneAsyncAction* PopulateSceneAsync(AOculusXRSceneActor* SceneActor, float CheckLoopTimeSeconds);
+
+	/** Builds the data derived from a populated scene: anchor registry, scene BVH, surface samples and flight octree. */
+	static void FinishScenePopulation(UWorld* World, AActor* SceneRoot);
+};
+
+/** Same as PopulateSceneAsync for a replayed scene capture, which is populated as soon as it's loaded. */
+UCLASS()
+class PHANTO_API UPopulateReplaySceneAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	TWeakObjectPtr<APhantoReplaySceneActor> ReplayActor;
+	FTimerHandle TimerHandle;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnReplayScenePopulated);
+
+	UPROPERTY(BlueprintAssignable)
+	FOnReplayScenePopulated OnScenePopulated;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnReplayScenePopulated OnFailed;
+
+	virtual void Activate() override;
+
+	/** Loads the capture of ReplayActor unless it's already loaded. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Replay", meta = (BlueprintInternalUseOnly = "true"))
+	static UPopulateReplaySceneAsyncAction* PopulateReplaySceneAsync(APhantoReplaySceneActor* ReplayActor);
+};
+
+/**
+ * Rebuilds only the navmesh tiles overlapping a set of bounds instead of the whole nav data.
+ * Tiles are handed to the generator in small batches so that no single frame pays for the whole rebuild.
+ */
+UCLASS()
+class PHANTO_API URebuildNavigationTilesAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	TWeakObjectPtr<UWorld> World;
+	TArray<FBox> DirtyBounds;
+	float FrameBudgetMs;
+	FTimerHandle TimerHandle;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnNavigationTilesRebuilt, int32, TilesRebuilt, float, DurationMs);
+
+	UPROPERTY(BlueprintAssignable)
+	FOnNavigationTilesRebuilt OnRebuilt;
+
+	virtual void Activate() override;
+
+	/** Dirties and rebuilds the tiles overlapping Bounds, spending at most FrameBudgetMs per frame submitting work. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static URebuildNavigationTilesAsyncAction* RebuildNavigationInBounds(UObject* WorldContextObject, const TArray<FBox>& Bounds, float FrameBudgetMs = 2.f);
+
+	/** Same as RebuildNavigationInBounds, using the component bounds of the given (changed) scene anchor actors. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static URebuildNavigationTilesAsyncAction* RebuildNavigationAroundAnchors(UObject* WorldContextObject, const TArray<AActor*>& Anchors, float FrameBudgetMs = 2.f);
+
+private:
+	TArray<FBox> PendingTiles;
+	TWeakObjectPtr<ANavigationData> NavData;
+	int32 NumTiles = 0;
+	int32 TilesPerBatch = 1;
+	double StartTime = 0;
+
+	void TickRebuild();
+	void Finish();
 };
 
 /**
@@ -51,12 +124,39 @@ public:
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "Angle Between (in Degrees)", CompactNodeTitle = "Degrees Between"), Category = "Math|Vector")
 	static double AngleBetween(FVector const& A, FVector const& B);
 
+	/** Angles in degrees between A[i] and B[i]. Inputs don't need to be normalized. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Angles Between (in Degrees)"), Category = "Math|Vector")
+	static void AnglesBetween(TArray<FVector> const& A, TArray<FVector> const& B, TArray<double>& Degrees);
+
+	/** Angles in degrees between Direction and each of Vectors. Inputs don't need to be normalized. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Angles To Direction (in Degrees)"), Category = "Math|Vector")
+	static void AnglesToDirection(FVector const& Direction, TArray<FVector> const& Vectors, TArray<double>& Degrees);
+
+	/** Indices of the locations within HalfAngleDegrees of Direction seen from Origin, and within MaxDistance if positive. */
+	UFUNCTION(BlueprintCallable, Category = "Math|Vector")
+	static void FindInCone(FVector const& Origin, FVector const& Direction, double HalfAngleDegrees, TArray<FVector> const& Locations, TArray<int32>& Indices, double MaxDistance = 0);
+
 	UFUNCTION(BlueprintCallable, meta = (DeterminesOutputType="TargetClass", ExpandBoolAsExecs="IsValid", CompactNodeTitle = "Cast"), Category = "Utilities|Casting")
 	static UObject* DynamicCast(UObject* Object, TSubclassOf<UObject> TargetClass, bool & IsValid);
 
 	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
 	static void SetLinkData(UNavLinkCustomComponent* NavLink, const FVector& RelativeStart, const FVector& RelativeEnd, ENavLinkDirection::Type Direction);
 
+	/**
+	 * Same as SetLinkData for a whole set of links at once. The nav octree is locked while the links are
+	 * modified, so each link is re-registered exactly once, and the union of their bounds is dirtied at once.
+	 * When the octree was already locked (static navigation), existing links are updated in place instead.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	static void SetLinkDataBatch(const TArray<UNavLinkCustomComponent*>& NavLinks, const TArray<FVector>& RelativeStarts, const TArray<FVector>& RelativeEnds, const TArray<TEnumAsByte<ENavLinkDirection::Type>>& Directions);
+
+	/**
+	 * Merges the near-duplicate links of NavLinks (read through GetLinkData). Redundant links are unregistered and
+	 * returned in RemovedLinks, kept links are moved to the average of their cluster.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	static void OptimizeLinkSet(const TArray<UNavLinkCustomComponent*>& NavLinks, const FPhantoNavLinkMergeSettings& Settings, TArray<UNavLinkCustomComponent*>& RemovedLinks, int32& NumLinksBefore, int32& NumLinksAfter);
+
 	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
 	static void GetLinkData(const UNavLinkCustomComponent* NavLink, FVector& LeftPt, FVector& RightPt, TEnumAsByte<ENavLinkDirection::Type>& Direction);
 
@@ -66,6 +166,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI|Navigation", meta = (WorldContext = "WorldContextObject"))
 	static void RebuildAll(UObject* WorldContextObject);
 
+	/**
+	 * Splits Bounds into one dirty area per overlapped navmesh tile of NavData. Bounds reaching past the existing tiles
+	 * are added whole too, so the missing tiles get created. Returns the number of tiles touched, new ones included.
+	 */
+	static int32 GatherDirtyTiles(const ANavigationData& NavData, TConstArrayView<FBox> Bounds, TArray<FBox>& OutTileBounds);
+
 	UFUNCTION(BlueprintCallable, Category = "AI|Navigation", meta = (WorldContext = "WorldContextObject"))
 	static void SetRebuildingSuspended(UObject* WorldContextObject, const bool bNewSuspend);
 
@@ -75,6 +181,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
 	static void ConfigureNavigationSystemAsStatic(bool bIsStatic);
 
+	/** Prefer UPhantoNavigationSubsystem build windows, which switch between dynamic and static generation on their own. */
 	UFUNCTION(BlueprintCallable, Category = "AI|Navigation", meta = (WorldContext = "WorldContextObject"))
 	static void SetNavigationRuntimeGenerationMode(UObject* WorldContextObject, ERuntimeGenerationType Mode);
 
@@ -83,4 +190,8 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	static void SetPreciseReachThreshold(UPathFollowingComponent* Component, float AgentRadiusMultiplier, float AgentHalfHeightMultiplier);
+
+	/** Writes the populated scene of SceneActor to a capture file for APhantoReplaySceneActor, under Saved/SceneCaptures if Path is empty. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Replay")
+	static bool CaptureSceneToFile(AActor* SceneActor, const FString& Path);
 };
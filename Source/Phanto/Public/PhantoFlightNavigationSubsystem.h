@@ -0,0 +1,57 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoFlightNavigationSubsystem.generated.h"
+
+struct FPhantoFlightOctree;
+
+/**
+ * Free space navigation for flying agents, built from the scene mesh once the room is populated.
+ *
+ * The octree is immutable once built; a rebuild swaps in a new one, so path searches running on worker threads keep
+ * using the snapshot they started with.
+ */
+UCLASS()
+class PHANTO_API UPhantoFlightNavigationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Whether Populate Scene Async builds the octree, with the default voxel size, before reporting the scene populated.
+	 * Off by default, the build runs on the game thread in the same frame as the other scene builds.
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Flight Navigation")
+	bool bBuildOnScenePopulated = false;
+
+	/** Builds the flight octree over Bounds. Returns the build time in milliseconds. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Flight Navigation")
+	float BuildFromBounds(const FBox& Bounds, float VoxelSize = 10, TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic);
+
+	/** Builds the flight octree over the combined bounds of Actors and of the actors attached to or owned by them. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Flight Navigation")
+	float BuildFromActors(const TArray<AActor*>& Actors, float VoxelSize = 10, TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic);
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Flight Navigation")
+	void Clear();
+
+	UFUNCTION(BlueprintPure, Category = "AI|Flight Navigation")
+	bool IsBuilt() const { return Octree.IsValid(); }
+
+	/** True when Location is inside the built volume and not in a blocked voxel. */
+	UFUNCTION(BlueprintPure, Category = "AI|Flight Navigation")
+	bool IsLocationFree(const FVector& Location) const;
+
+	/** Synchronous path search, prefer the Find Flight Path async node from gameplay code. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Flight Navigation")
+	bool FindPath(const FVector& Start, const FVector& End, TArray<FVector>& OutPath) const;
+
+	TSharedPtr<const FPhantoFlightOctree> GetOctree() const { return Octree; }
+
+private:
+	TSharedPtr<const FPhantoFlightOctree> Octree;
+};
@@ -0,0 +1,66 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+class UWorld;
+
+/**
+ * Sparse voxel octree of the blocked space of a room, used for flying navigation.
+ *
+ * Leaves are bricks of 4x4x4 voxels stored as a 64 bit mask. Above them, each layer only stores the nodes that
+ * contain blocked space, as a 4 byte packed (first child, child mask) pair; the children of a node are contiguous in
+ * the layer below, so a child is found with a popcount of the mask. Anything not stored is free space.
+ *
+ * Paths are searched over leaf bricks (a brick with any blocked voxel is considered blocked, which doubles as a
+ * clearance margin) and smoothed with line of sight checks.
+ */
+struct PHANTO_API FPhantoFlightOctree
+{
+	struct FNode
+	{
+		uint32 Packed;
+
+		static FNode Make(uint32 FirstChild) { return { FirstChild << 8 }; }
+		uint32 FirstChild() const { return Packed >> 8; }
+		uint8 ChildMask() const { return uint8(Packed & 0xff); }
+		void AddChild(uint32 Octant) { Packed |= 1u << Octant; }
+	};
+
+	/** Builds the octree by testing boxes against the physics scene top-down, one layer at a time in parallel. */
+	void Build(const UWorld& World, const FBox& InBounds, float InVoxelSize, ECollisionChannel Channel);
+
+	bool IsEmpty() const { return Leaves.Num() == 0; }
+	const FBox& GetBounds() const { return Bounds; }
+	double GetBrickSize() const { return BrickSize; }
+
+	/** Memory used by the nodes and leaves. */
+	SIZE_T GetAllocatedSize() const;
+	int32 GetNumNodes() const;
+	int32 GetNumLeaves() const { return Leaves.Num(); }
+
+	bool IsLocationFree(const FVector& Location) const;
+
+	/** A* over the bricks, 26-connected, followed by string pulling. Safe to call from any thread. */
+	bool FindPath(const FVector& Start, const FVector& End, TArray<FVector>& OutPath, int32 MaxIterations = 20000) const;
+
+private:
+	FBox Bounds = FBox(ForceInit);
+	double VoxelSize = 0;
+	double BrickSize = 0;
+
+	/** Number of layers above the leaves; the root is alone in Layers[Depth]. */
+	int32 Depth = 0;
+	TArray<TArray<FNode>> Layers;
+	TArray<uint64> Leaves;
+
+	FIntVector GetBrick(const FVector& Location) const;
+	FVector GetBrickCenter(const FIntVector& Brick) const;
+
+	/** Returns the leaf of a brick, or INDEX_NONE when the brick is entirely free. Out of bounds bricks return -2. */
+	int32 FindLeaf(const FIntVector& Brick) const;
+	bool IsBrickBlocked(const FIntVector& Brick) const { return FindLeaf(Brick) != INDEX_NONE; }
+	bool HasLineOfSight(const FIntVector& From, const FIntVector& To) const;
+};
@@ -0,0 +1,103 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PhantoGooSplatManager.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+/**
+ * Renders every goo splat of the room as instances of a single mesh.
+ *
+ * All MaxSplats instances are created up front and splats are only moved in and out of them; once the budget is
+ * reached the oldest splat is recycled. Splats are indexed in a spatial hash so cleanup only visits nearby cells.
+ */
+UCLASS()
+class PHANTO_API APhantoGooSplatManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APhantoGooSplatManager();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Goo")
+	TObjectPtr<UInstancedStaticMeshComponent> Splats;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Goo", meta = (ClampMin = "1"))
+	int32 MaxSplats = 256;
+
+	/** Size of the spatial hash cells, about the size of a splat. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Goo", meta = (ClampMin = "1"))
+	float CellSize = 50;
+
+	/** Radius of the mesh at scale 1, to scale instances to the requested splat radius. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Goo", meta = (ClampMin = "0.01"))
+	float MeshRadius = 50;
+
+	/** Leaves a splat on every impact of the projectile managers of the level. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Goo")
+	bool bSplatProjectileImpacts = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Goo")
+	float ProjectileSplatRadius = 15;
+
+	/** Adds a splat on a surface, recycling the oldest one when the budget is reached. */
+	UFUNCTION(BlueprintCallable, Category = "Goo")
+	void AddSplat(FVector Location, FVector Normal, float Radius);
+
+	/** Removes the splats touching the sphere. Returns how many were removed. */
+	UFUNCTION(BlueprintCallable, Category = "Goo")
+	int32 CleanSplatsInSphere(FVector Center, float Radius);
+
+	UFUNCTION(BlueprintCallable, Category = "Goo")
+	void ClearSplats();
+
+	UFUNCTION(BlueprintPure, Category = "Goo")
+	int32 GetNumSplats() const { return NumSplats; }
+
+	/** Sum of the areas of the live splats, in cm². */
+	UFUNCTION(BlueprintPure, Category = "Goo")
+	float GetCoveredArea() const { return CoveredArea; }
+
+	/** Number of splats recycled to stay under MaxSplats. */
+	UFUNCTION(BlueprintPure, Category = "Goo")
+	int32 GetNumRecycled() const { return NumRecycled; }
+
+	/** First goo splat manager of the world of WorldContext. */
+	UFUNCTION(BlueprintPure, meta = (WorldContext = "WorldContext"), Category = "Goo")
+	static APhantoGooSplatManager* GetGooSplatManager(const UObject* WorldContext);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/** Per instance, INDEX_NONE radius for free ones. */
+	TArray<FVector> Locations;
+	TArray<float> Radii;
+	TArray<uint32> Serials;
+	TArray<FIntVector> Cells;
+
+	TArray<int32> FreeSlots;
+
+	/** Slots in allocation order with the serial they had then, stale entries are skipped when popped. */
+	TArray<TPair<int32, uint32>> AllocationOrder;
+	int32 AllocationHead = 0;
+
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Grid;
+
+	uint32 NextSerial = 1;
+	int32 NumSplats = 0;
+	int32 NumRecycled = 0;
+	float CoveredArea = 0;
+	float MaxRadius = 0;
+
+	int32 AllocateSlot();
+	void FreeSlot(int32 Slot);
+	FIntVector GetCell(const FVector& Location) const;
+
+	UFUNCTION()
+	void HandleProjectileImpact(const FHitResult& Hit, AActor* Instigator);
+};
@@ -0,0 +1,96 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/OutputDevice.h"
+#include <atomic>
+
+struct FPhantoLogLine
+{
+	/** Points into a copy of the line, only valid during the visit. */
+	FStringView Text;
+	FName Category;
+	ELogVerbosity::Type Verbosity;
+	double Time;
+};
+
+/**
+ * Output device keeping the last log lines in a fixed ring of pre-allocated slots.
+ *
+ * Writers claim a slot with an atomic increment and publish it with its sequence number once written, so logging
+ * from any thread never locks nor allocates. Lines longer than the slot size are truncated.
+ */
+class PHANTO_API FPhantoLogRingBuffer : public FOutputDevice
+{
+public:
+	FPhantoLogRingBuffer(int32 InNumLines = 512, int32 InMaxLineLength = 256);
+
+	virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override;
+	virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category, double Time) override;
+	virtual bool CanBeUsedOnAnyThread() const override { return true; }
+	virtual bool CanBeUsedOnMultipleThreads() const override { return true; }
+	virtual bool IsMemoryOnly() const override { return true; }
+
+	/** Cursor after the last line written. */
+	uint64 GetCursor() const { return WriteCursor.load(std::memory_order_acquire); }
+
+	int32 GetNumLines() const { return NumLines; }
+
+	/**
+	 * Calls Visitor with every line written since Cursor that is still in the buffer, and returns the cursor to pass
+	 * next time. Each line is copied to a local buffer and its sequence checked again after the copy: lines a writer
+	 * lapping the ring overwrote meanwhile are skipped rather than visited torn. Use the view before returning.
+	 */
+	template <typename FunctorType>
+	uint64 ForEachLineSince(uint64 Cursor, FunctorType&& Visitor) const
+	{
+		TArray<TCHAR, TInlineAllocator<256>> Copy;
+		Copy.SetNumUninitialized(MaxLineLength);
+
+		auto const End = GetCursor();
+		auto Index = FMath::Max(Cursor, End > uint64(NumLines) ? End - NumLines : 0);
+		for (; Index < End; ++Index)
+		{
+			auto const& Slot = Slots[Index % NumLines];
+			auto const Sequence = Slot.Sequence.load(std::memory_order_acquire);
+
+			// Still being written, pick it up next time.
+			if (Sequence < Index + 1)
+				break;
+
+			// Overwritten since the cursor was read.
+			if (Sequence > Index + 1)
+				continue;
+
+			auto const Length = FMath::Clamp(Slot.Length, 0, MaxLineLength);
+			FPlatformMemory::Memcpy(Copy.GetData(), &Text[(Index % NumLines) * MaxLineLength], Length * sizeof(TCHAR));
+			FPhantoLogLine Line{ FStringView(Copy.GetData(), Length), Slot.Category, Slot.Verbosity, Slot.Time };
+
+			// The copy is only good if no writer claimed the slot while it was made.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Slot.Sequence.load(std::memory_order_relaxed) != Sequence)
+				continue;
+
+			Visitor(Line);
+		}
+		return Index;
+	}
+
+private:
+	struct FSlot
+	{
+		/** Index of the line + 1 once published, 0 while being written. */
+		std::atomic<uint64> Sequence{ 0 };
+		int32 Length = 0;
+		FName Category;
+		ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+		double Time = 0;
+	};
+
+	int32 NumLines;
+	int32 MaxLineLength;
+	TUniquePtr<FSlot[]> Slots;
+	TUniquePtr<TCHAR[]> Text;
+	std::atomic<uint64> WriteCursor{ 0 };
+};
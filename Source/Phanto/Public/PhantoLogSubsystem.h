@@ -0,0 +1,44 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "PhantoLogSubsystem.generated.h"
+
+class FPhantoLogRingBuffer;
+
+/**
+ * Captures the log into a ring buffer for the in-headset log panel.
+ *
+ * Readers keep a cursor and only fetch the lines written since; C++ can visit them in place through GetBuffer.
+ */
+UCLASS()
+class PHANTO_API UPhantoLogSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Cursor after the last captured line; pass 0 to get every line still in the buffer. */
+	UFUNCTION(BlueprintPure, Category = "Debug|Log")
+	int64 GetLogCursor() const;
+
+	/** Copies the lines written since Cursor, at most MaxLines of the most recent ones. Returns the next cursor. */
+	UFUNCTION(BlueprintCallable, Category = "Debug|Log")
+	int64 GetLinesSince(int64 Cursor, TArray<FString>& Lines, int32 MaxLines = 64) const;
+
+	/**
+	 * Appends the lines written since Cursor to Text, one per line, and drops whole lines from its start to keep it
+	 * under MaxCharacters. Returns the next cursor.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Debug|Log")
+	int64 AppendLinesSince(int64 Cursor, UPARAM(ref) FString& Text, int32 MaxCharacters = 8192) const;
+
+	const FPhantoLogRingBuffer* GetBuffer() const { return Buffer.Get(); }
+
+private:
+	TUniquePtr<FPhantoLogRingBuffer> Buffer;
+};
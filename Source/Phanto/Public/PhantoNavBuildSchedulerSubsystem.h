@@ -0,0 +1,103 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoNavBuildSchedulerSubsystem.generated.h"
+
+class ARecastNavMesh;
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoNavBuildStats
+{
+	GENERATED_BODY()
+
+	/** Frames during which tiles were being generated. */
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 BuildFrames = 0;
+
+	/** Build frames that went over the target frame time. */
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 OverrunFrames = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	float WorstBuildFrameMs = 0;
+
+	/** Smoothed frame time measured while building. */
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	float AverageBuildFrameMs = 0;
+
+	/** Headroom left in the current frame for navigation work. */
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	float BudgetMs = 0;
+
+	/** Number of tile generation jobs the generator is allowed to run at the same time. */
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 TileJobs = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 RemainingTiles = 0;
+};
+
+/**
+ * Keeps runtime navmesh generation inside the frame budget of the headset.
+ *
+ * While tiles are being built, the frame time is measured every frame and the number of tile jobs the recast
+ * generator can run concurrently is adjusted (halved on overrun, increased while there is headroom). Gameplay
+ * can open critical sections during which no new tiles are started at all.
+ */
+UCLASS()
+class PHANTO_API UPhantoNavBuildSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Frame time the scheduler tries to stay under, 90 Hz by default. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Navigation")
+	float TargetFrameTimeMs = 11.1f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Navigation")
+	int32 MaxTileJobs = 4;
+
+	/** Pauses navigation building until the matching EndCriticalSection. Sections are counted per reason. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void BeginCriticalSection(FName Reason);
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void EndCriticalSection(FName Reason);
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	bool IsPaused() const { return CriticalSections.Num() > 0; }
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	bool IsBuilding() const;
+
+	/** Progress of the current build, from 0 to 1 (1 when idle). */
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	float GetBuildProgress() const;
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	FPhantoNavBuildStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void ResetStats();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TMap<FName, int32> CriticalSections;
+	FPhantoNavBuildStats Stats;
+	int32 PeakRemainingTiles = 0;
+
+	/** Navmesh suspended by the critical sections and its tile job count before they opened. */
+	TWeakObjectPtr<ARecastNavMesh> PausedNavMesh;
+	int32 TileJobsBeforePause = 0;
+
+	ARecastNavMesh* GetNavMesh() const;
+	void ApplyPause(bool bPause);
+};
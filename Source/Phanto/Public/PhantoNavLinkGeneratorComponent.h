@@ -0,0 +1,139 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/Navigation/NavLinkDefinition.h"
+#include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "PhantoNavLinkSetOptimizer.h"
+#include "WorldCollision.h"
+#include "PhantoNavLinkGeneratorComponent.generated.h"
+
+class ANavigationData;
+class ARecastNavMesh;
+class UNavLinkCustomComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnNavLinksGenerated, int32, NumLinks, float, DurationMs);
+
+/**
+ * Finds jump/drop links between ledges of the built navmesh (couch to floor, table to floor...) and registers them.
+ *
+ * Boundary edges are extracted from every navmesh tile in parallel, sampled and paired with lower samples through
+ * a spatial hash. The jump arcs of the candidates are validated with async line traces (run by the engine on worker
+ * threads) and the surviving links are registered with a single SetLinkDataBatch call.
+ */
+UCLASS(ClassGroup = (Navigation), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
+class PHANTO_API UPhantoNavLinkGeneratorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** Distance between two ledge samples along a navmesh boundary edge. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation", meta = (ClampMin = "1"))
+	float EdgeSampleSpacing = 40;
+
+	/** How far out from a boundary edge we look for navmesh to tell the inner side from the outer side. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation", meta = (ClampMin = "1"))
+	float LedgeProbeDistance = 15;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation", meta = (ClampMin = "0"))
+	float MinDropHeight = 20;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation", meta = (ClampMin = "0"))
+	float MaxDropHeight = 120;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation", meta = (ClampMin = "0"))
+	float MaxHorizontalDistance = 80;
+
+	/** Height of the jump arc above the straight line between the link ends. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation|Validation", meta = (ClampMin = "0"))
+	float ArcHeight = 25;
+
+	/** Offset above the link ends the arc is traced at, so the traces don't graze the surfaces they start from. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation|Validation", meta = (ClampMin = "0"))
+	float ArcTraceHeightOffset = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation|Validation", meta = (ClampMin = "1"))
+	int32 ArcSegments = 6;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation|Validation")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation")
+	TEnumAsByte<ENavLinkDirection::Type> LinkDirection = ENavLinkDirection::BothWays;
+
+	/** Merges near-duplicate links (e.g. neighbor samples along the same ledge) before registering them. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation|Optimization")
+	bool bOptimizeLinks = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation|Optimization", meta = (EditCondition = "bOptimizeLinks"))
+	FPhantoNavLinkMergeSettings MergeSettings;
+
+	/**
+	 * Optional actor spawned at every link, whose UNavLinkCustomComponent is used for the link (e.g. a proxy that
+	 * handles the jump when the link is reached). Links are added as components of the owner when not set.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Generation")
+	TSubclassOf<AActor> LinkProxyClass;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnNavLinksGenerated OnLinksGenerated;
+
+	/**
+	 * Starts generating links against the default navmesh. OnLinksGenerated is broadcast once the arcs are validated.
+	 * While the navmesh is being built, the generation waits for the build to finish.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void GenerateLinks();
+
+	/** Unregisters all the generated links. They are kept around and reused by the next generation. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void ClearLinks();
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	bool IsGenerating() const { return bGenerating || bWaitingForNavigation; }
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	TArray<UNavLinkCustomComponent*> GetLinks() const;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	struct FLedgeSample
+	{
+		FVector Location;
+		FVector Outward;
+	};
+
+	struct FLinkCandidate
+	{
+		FVector Top;
+		FVector Bottom;
+		bool bValid = false;
+	};
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UNavLinkCustomComponent>> Links;
+
+	int32 NumActiveLinks = 0;
+
+	TArray<FLinkCandidate> Candidates;
+	int32 PendingTraces = 0;
+	bool bGenerating = false;
+	bool bWaitingForNavigation = false;
+	double GenerationStartTime = 0;
+
+	UFUNCTION()
+	void HandleNavigationGenerationFinished(ANavigationData* NavData);
+
+	void ExtractLedgeSamples(const ARecastNavMesh& NavMesh, TArray<FLedgeSample>& OutSamples) const;
+	void PairLedgeSamples(const ARecastNavMesh& NavMesh, TConstArrayView<FLedgeSample> Samples);
+	void TraceArcs();
+	void OnArcTraced(const FTraceHandle& Handle, FTraceDatum& Datum);
+	void OptimizeCandidates();
+	void FinishGeneration();
+
+	UNavLinkCustomComponent* AcquireLink(int32 Index, const FVector& Location);
+	void ReleaseLinks(int32 FirstIndex);
+};
@@ -0,0 +1,45 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/Navigation/NavLinkDefinition.h"
+#include "PhantoNavLinkSetOptimizer.generated.h"
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoNavLinkMergeSettings
+{
+	GENERATED_BODY()
+
+	/** Links whose starts and ends are both closer than this are considered redundant. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Optimization", meta = (ClampMin = "0"))
+	float EndpointTolerance = 30;
+
+	/** Maximum angle between two links for them to be merged. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Optimization", meta = (ClampMin = "0", ClampMax = "180"))
+	float MaxAngleDegrees = 20;
+
+	/** Whether the surviving link is moved to the average of the links merged into it, or kept as is. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Nav Link Optimization")
+	bool bAverageMergedLinks = true;
+};
+
+/**
+ * Merges near-duplicate nav links. Links are clustered on a spatial grid of their start points (cells as large as
+ * the tolerance), so each link is only compared with the links of the 27 surrounding cells.
+ */
+struct PHANTO_API FPhantoNavLinkSetOptimizer
+{
+	struct FLink
+	{
+		FVector Start;
+		FVector End;
+		ENavLinkDirection::Type Direction;
+	};
+
+	/**
+	 * Fills OutMergedInto with, for every link, the index of the link it was merged into (its own index for the
+	 * links that are kept). Kept links are updated in place when averaging is enabled. Returns the number of kept links.
+	 */
+	static int32 Optimize(TArray<FLink>& Links, const FPhantoNavLinkMergeSettings& Settings, TArray<int32>& OutMergedInto);
+};
@@ -0,0 +1,110 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "Engine/World.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoNavigationSubsystem.generated.h"
+
+class ANavigationData;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnNavigationBuildWindowClosed, float, WindowMs, float, BuildMs);
+
+/**
+ * Owns the runtime generation mode of the default nav data.
+ *
+ * The navmesh is kept static (octree locked) and only switches to dynamic generation inside build windows, opened
+ * while the room is actually changing. Dirty areas reported while a window is open are held back and rebuilt in a
+ * single consolidated build when the last window closes, after which the navmesh is locked back to static.
+ */
+UCLASS()
+class PHANTO_API UPhantoNavigationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FOnNavigationBuildWindowClosed OnBuildWindowClosed;
+
+	/** Opens a build window. Windows are counted per reason; the build runs once every window is closed. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void OpenBuildWindow(FName Reason);
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void CloseBuildWindow(FName Reason);
+
+	/** Adds bounds to rebuild when the current build window closes. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void AddDirtyBounds(const FBox& Bounds);
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	bool IsBuildWindowOpen() const { return OpenWindows.Num() > 0; }
+
+	/** True from the moment a build window opens until its consolidated build is done. */
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	bool IsDynamic() const { return State != EState::Static; }
+
+	/** Total time spent with dynamic generation enabled since the subsystem was created. */
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	float GetTotalDynamicTimeMs() const { return TotalDynamicMs; }
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	float GetLastBuildTimeMs() const { return LastBuildMs; }
+
+	/** Sets the runtime generation mode of NavData through its reflected property, and locks the octree when static. */
+	static void SetRuntimeGenerationMode(ANavigationData& NavData, ERuntimeGenerationType Mode);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class EState : uint8
+	{
+		Static,
+		Collecting,
+		Building,
+	};
+
+	EState State = EState::Static;
+	TMap<FName, int32> OpenWindows;
+	TArray<FBox> DirtyBounds;
+
+	double WindowStartTime = 0;
+	double BuildStartTime = 0;
+	float TotalDynamicMs = 0;
+	float LastBuildMs = 0;
+
+	ANavigationData* GetNavData() const;
+	void BeginCollecting();
+	void BeginBuild();
+	void FinishBuild();
+};
+
+/** Keeps a navigation build window open for the lifetime of the scope. */
+struct FPhantoScopedNavigationBuildWindow
+{
+	FPhantoScopedNavigationBuildWindow(UWorld* World, FName InReason)
+		: Subsystem(World ? World->GetSubsystem<UPhantoNavigationSubsystem>() : nullptr)
+		, Reason(InReason)
+	{
+		if (Subsystem)
+			Subsystem->OpenBuildWindow(Reason);
+	}
+
+	~FPhantoScopedNavigationBuildWindow()
+	{
+		if (Subsystem)
+			Subsystem->CloseBuildWindow(Reason);
+	}
+
+	UE_NONCOPYABLE(FPhantoScopedNavigationBuildWindow);
+
+private:
+	UPhantoNavigationSubsystem* Subsystem;
+	FName Reason;
+};
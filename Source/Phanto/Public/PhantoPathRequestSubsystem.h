@@ -0,0 +1,145 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "NavigationData.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "PhantoPathRequestSubsystem.generated.h"
+
+class UNavigationQueryFilter;
+
+/** Called with the request id and the path, null when no path was found. */
+DECLARE_DELEGATE_TwoParams(FPhantoPathRequestDelegate, uint32, FNavPathSharedPtr);
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoPathRequestStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 QueueDepth = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 PeakQueueDepth = 0;
+
+	/** Queries dispatched to the navigation system and not answered yet. */
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 InFlight = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 Completed = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	int32 CacheHits = 0;
+
+	/** Smoothed time from request to callback. */
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	float AverageLatencyMs = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Navigation")
+	float WorstLatencyMs = 0;
+};
+
+/**
+ * Queues path requests and feeds them to the asynchronous path finding of the navigation system a few per frame, so
+ * a whole wave asking for paths at once doesn't stall the game thread.
+ *
+ * Found paths are cached for a short time by start and goal cells, requests between the same cells reuse them.
+ */
+UCLASS()
+class PHANTO_API UPhantoPathRequestSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** New queries dispatched to the navigation system per frame. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Navigation")
+	int32 MaxDispatchesPerFrame = 4;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Navigation")
+	int32 MaxInFlight = 16;
+
+	/** Size of the cells start and goal locations are snapped to for caching, 0 disables the cache. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Navigation")
+	float CacheCellSize = 50;
+
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Navigation")
+	float CacheLifetime = 2;
+
+	/** Queues a path request, returns its id. Callback is always called on the game thread, unless the request is cancelled. */
+	uint32 RequestPath(const FNavAgentProperties& AgentProperties, const FVector& Start, const FVector& End, const UObject* Querier, FPhantoPathRequestDelegate Callback);
+
+	void CancelRequest(uint32 RequestId);
+
+	UFUNCTION(BlueprintPure, Category = "AI|Navigation")
+	FPhantoPathRequestStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void ResetStats();
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+	void ClearCache();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FRequest
+	{
+		uint32 Id;
+		FNavAgentProperties AgentProperties;
+		FVector Start;
+		FVector End;
+		TWeakObjectPtr<const UObject> Querier;
+		FPhantoPathRequestDelegate Callback;
+		double RequestTime;
+
+		/** Set when dispatched. */
+		const ANavigationData* NavData = nullptr;
+		TSubclassOf<UNavigationQueryFilter> FilterClass;
+	};
+
+	struct FCacheEntry
+	{
+		TArray<FNavPathPoint> Points;
+		double Time;
+	};
+
+	/** Paths only apply to the navigation data and filter they were found with, then start and goal cells. */
+	using FCacheKey = TTuple<const ANavigationData*, const UClass*, FIntVector, FIntVector>;
+
+	/** Expired entries are only pruned once the cache grows past this. */
+	static constexpr int32 MaxCacheEntries = 256;
+
+	TArray<FRequest> Pending;
+
+	/** Dispatched requests by navigation query id. */
+	TMap<uint32, FRequest> InFlight;
+
+	/** Requests cancelled by callbacks while Tick dispatches the queue. */
+	TSet<uint32> CancelledIds;
+	bool bDispatching = false;
+
+	TMap<FCacheKey, FCacheEntry> Cache;
+	FPhantoPathRequestStats Stats;
+	uint32 NextRequestId = 1;
+
+	FCacheKey GetCacheKey(const FRequest& Request) const;
+	bool TryCompleteFromCache(FRequest& Request, ANavigationData& NavData);
+
+	/** Filter of the AI controller of Querier, or of the pawn's, null for the default filter. */
+	static TSubclassOf<UNavigationQueryFilter> GetFilterClass(const UObject* Querier);
+	void Complete(FRequest& Request, FNavPathSharedPtr Path);
+	void HandlePathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+	UFUNCTION()
+	void HandleNavigationGenerationFinished(ANavigationData* NavData);
+};
@@ -0,0 +1,30 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PhantoPoolable.generated.h"
+
+UINTERFACE(MinimalAPI, Blueprintable)
+class UPhantoPoolable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Optional hooks of actors recycled by UPhantoActorPoolSubsystem, to reset the state the pool doesn't know about.
+ */
+class PHANTO_API IPhantoPoolable
+{
+	GENERATED_BODY()
+
+public:
+	/** Called after the actor is taken out of the pool, shown and moved to its new transform. */
+	UFUNCTION(BlueprintNativeEvent, Category = "Pool")
+	void OnAcquiredFromPool();
+
+	/** Called when the actor is returned to the pool, before it's hidden. */
+	UFUNCTION(BlueprintNativeEvent, Category = "Pool")
+	void OnReleasedToPool();
+};
@@ -0,0 +1,114 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "GameFramework/Actor.h"
+#include "WorldCollision.h"
+#include "PhantoProjectileManager.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UNiagaraSystem;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPhantoProjectileImpact, const FHitResult&, Hit, AActor*, Instigator);
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoProjectileStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+	int32 LiveProjectiles = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+	int32 PeakLiveProjectiles = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+	int32 Fired = 0;
+
+	/** Shots refused because MaxLiveProjectiles was reached. */
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+	int32 Rejected = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+	int32 Impacts = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+	int32 Expired = 0;
+};
+
+/**
+ * Simulates every goo ball of the level, instead of an actor per shot.
+ *
+ * Projectiles are stored as parallel arrays, integrated together once per frame and rendered as instances of a
+ * single mesh. Each frame's motion is traced asynchronously and the results are read on the next frame, so impacts
+ * are reported one frame late but collision never stalls the game thread. Impact effects come from the Niagara
+ * component pool.
+ */
+UCLASS()
+class PHANTO_API APhantoProjectileManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APhantoProjectileManager();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Projectiles")
+	TObjectPtr<UInstancedStaticMeshComponent> Projectiles;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectiles", meta = (ClampMin = "1"))
+	int32 MaxLiveProjectiles = 64;
+
+	/** Projectiles that haven't hit anything after this long are removed. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectiles")
+	float MaxLifetime = 5;
+
+	/** Multiplier of the world gravity. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectiles")
+	float GravityScale = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectiles")
+	float ProjectileScale = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectiles")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectiles")
+	TObjectPtr<UNiagaraSystem> ImpactEffect;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnPhantoProjectileImpact OnProjectileImpact;
+
+	/** Fires a projectile. Returns false when MaxLiveProjectiles are already in flight. */
+	UFUNCTION(BlueprintCallable, Category = "Projectiles")
+	bool FireProjectile(FVector Location, FVector Velocity, AActor* Instigator);
+
+	UFUNCTION(BlueprintCallable, Category = "Projectiles")
+	void ClearProjectiles();
+
+	UFUNCTION(BlueprintPure, Category = "Projectiles")
+	FPhantoProjectileStats GetStats() const { return Stats; }
+
+	/** First projectile manager of the world of WorldContext. */
+	UFUNCTION(BlueprintPure, meta = (WorldContext = "WorldContext"), Category = "Projectiles")
+	static APhantoProjectileManager* GetProjectileManager(const UObject* WorldContext);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> Ages;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+
+	/** Trace of the motion of the previous frame, read back at the start of this one. */
+	TArray<FTraceHandle> Traces;
+
+	TArray<FTransform> InstanceTransforms;
+	FPhantoProjectileStats Stats;
+
+	void RemoveProjectile(int32 Index);
+	void HandleImpact(int32 Index, const FHitResult& Hit);
+	void UpdateInstances();
+};
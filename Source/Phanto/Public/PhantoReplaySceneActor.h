@@ -0,0 +1,57 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PhantoReplaySceneActor.generated.h"
+
+class UMaterialInterface;
+
+/**
+ * Stands in for the scene actor when there is no headset: spawns the anchors of a scene capture (see
+ * PhantoSceneCapture.h) as actors with collision and a scene anchor component, so scene population, navigation
+ * and gameplay run the same as on device, e.g. in the editor or in automated runs.
+ *
+ * The module depends on the OculusXR plugins, which only support Win64 and Android, so replays run on Win64 hosts.
+ */
+UCLASS()
+class PHANTO_API APhantoReplaySceneActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APhantoReplaySceneActor();
+
+	/** Capture to load, absolute or relative to the project directory. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scene|Replay")
+	FString CapturePath;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scene|Replay")
+	bool bLoadOnBeginPlay = true;
+
+	/** Material of the anchor meshes, which are hidden without one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scene|Replay")
+	TObjectPtr<UMaterialInterface> SurfaceMaterial;
+
+	/** Replaces the current anchors with the ones of the capture at Path. Returns false if it couldn't be opened. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Replay")
+	bool LoadCapture(const FString& Path);
+
+	UFUNCTION(BlueprintCallable, Category = "Scene|Replay")
+	void ClearScene();
+
+	UFUNCTION(BlueprintPure, Category = "Scene|Replay")
+	bool IsScenePopulated() const { return AnchorActors.Num() > 0; }
+
+	UFUNCTION(BlueprintPure, Category = "Scene|Replay")
+	TArray<AActor*> GetAnchorActors() const { return AnchorActors; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> AnchorActors;
+};
@@ -0,0 +1,103 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/TimerHandle.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "PhantoRoamPointSubsystem.generated.h"
+
+class ANavigationData;
+class UNavArea;
+
+/**
+ * Precomputed roam destinations, so enemies don't query the navmesh for a random reachable point on every decision.
+ *
+ * Once navigation builds settle, points are sampled on a jittered grid over every nav poly (one per cell, plus the
+ * center of polys too small to hold one) and tagged with their nav area and region. Regions are the connected
+ * components of the navmesh polys, so a point of the same region as the agent is reachable without links.
+ *
+ * Points are stored as parallel arrays sorted by (region, area), which makes random picks in a region or area O(1),
+ * and indexed by a 2D grid in compressed row layout for radius queries.
+ */
+UCLASS()
+class PHANTO_API UPhantoRoamPointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Distance between sampled points. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Roaming")
+	float PointSpacing = 60;
+
+	/** Size of the cells of the spatial grid used by radius queries. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Roaming")
+	float GridCellSize = 200;
+
+	/** Whether points are resampled every time navigation generation finishes. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Roaming")
+	bool bRebuildAfterNavigationBuild = true;
+
+	/** Time without navigation build finishing before the points are resampled, 0 resamples after every build. */
+	UPROPERTY(BlueprintReadWrite, Category = "AI|Roaming", meta = (ClampMin = "0"))
+	float RebuildDelay = 0.5f;
+
+	/** Resamples the points from the default navmesh. Returns the number of points. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Roaming")
+	int32 RebuildRoamPoints();
+
+	UFUNCTION(BlueprintPure, Category = "AI|Roaming")
+	int32 GetNumRoamPoints() const { return Locations.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "AI|Roaming")
+	int32 GetNumRegions() const { return RegionRanges.Num(); }
+
+	/** Region of the closest point within MaxDistance of Location, INDEX_NONE if there is none. */
+	UFUNCTION(BlueprintPure, Category = "AI|Roaming")
+	int32 GetRegionAt(const FVector& Location, float MaxDistance = 100) const;
+
+	/** Random point, optionally restricted to a region (INDEX_NONE for any) and a nav area. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Roaming")
+	bool GetRandomRoamPoint(FVector& OutLocation, int32 Region = -1, TSubclassOf<UNavArea> AreaClass = nullptr) const;
+
+	/** Random point within Radius of Origin that is in the same region as Origin. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Roaming")
+	bool GetRandomReachableRoamPoint(const FVector& Origin, float Radius, FVector& OutLocation) const;
+
+	/** Closest point to Origin within Radius. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Roaming")
+	bool GetNearestRoamPoint(const FVector& Origin, float Radius, FVector& OutLocation) const;
+
+protected:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+private:
+	TArray<FVector3f> Locations;
+	TArray<int32> Regions;
+	TArray<uint8> Areas;
+
+	/** First point and number of points of each region. */
+	TArray<FIntPoint> RegionRanges;
+
+	/** First point and number of points of each (region, area) pair. */
+	TMap<uint32, FIntPoint> RegionAreaRanges;
+
+	/** The grid cell of a point is GridOrigin + (X, Y) * GridCellSize; GridPoints[GridStarts[Cell]..GridStarts[Cell + 1]] are its points. */
+	FVector2D GridOrigin = FVector2D::ZeroVector;
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+	TArray<int32> GridStarts;
+	TArray<int32> GridPoints;
+
+	FTimerHandle RebuildTimerHandle;
+
+	ANavigationData* GetNavData() const;
+
+	UFUNCTION()
+	void HandleNavigationGenerationFinished(ANavigationData* NavData);
+
+	/** Calls Visitor(PointIndex, DistanceSquared) for every point within Radius of Origin. */
+	template <typename FunctorType>
+	void ForEachPointInRadius(const FVector& Origin, float Radius, FunctorType&& Visitor) const;
+};
@@ -0,0 +1,100 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhantoSceneTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoSceneAnchorRegistry.generated.h"
+
+class UBlueprintXRSceneAnchorComponent;
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoSceneAnchorData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scene|Anchors")
+	EPhantoSemanticLabel Label = EPhantoSemanticLabel::Unknown;
+
+	/** World bounds of the anchor's actor. */
+	UPROPERTY(BlueprintReadOnly, Category = "Scene|Anchors")
+	FBox Bounds = FBox(ForceInit);
+
+	/** Whether the anchor is flat, like walls, floor and ceiling, rather than a volume. */
+	UPROPERTY(BlueprintReadOnly, Category = "Scene|Anchors")
+	bool bIsPlane = false;
+
+	/** Size of the plane along its two largest axes. */
+	UPROPERTY(BlueprintReadOnly, Category = "Scene|Anchors")
+	FVector2D PlaneSize = FVector2D::ZeroVector;
+
+	/** Axis of the plane, along the thinnest axis of the anchor. */
+	UPROPERTY(BlueprintReadOnly, Category = "Scene|Anchors")
+	FVector PlaneNormal = FVector::ZeroVector;
+
+	/** Size of the anchor along its local axes. */
+	UPROPERTY(BlueprintReadOnly, Category = "Scene|Anchors")
+	FVector VolumeSize = FVector::ZeroVector;
+};
+
+/**
+ * Every scene anchor of the world, kept as parallel arrays of cached label, bounds and sizes.
+ *
+ * Anchor components register themselves on begin play and refresh their row when their actor moves; the scene
+ * population refreshes every row once the classifications are known. Queries scan the label and bounds arrays only,
+ * without touching the components.
+ */
+UCLASS()
+class PHANTO_API UPhantoSceneAnchorRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterAnchor(UBlueprintXRSceneAnchorComponent* Anchor);
+	void UnregisterAnchor(UBlueprintXRSceneAnchorComponent* Anchor);
+
+	/** Recomputes the cached data of an anchor, registering it if needed. */
+	void UpdateAnchor(UBlueprintXRSceneAnchorComponent* Anchor);
+
+	/** Recomputes the cached data of every anchor, e.g. once the scene is populated. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Anchors")
+	void RefreshAnchors();
+
+	UFUNCTION(BlueprintPure, Category = "Scene|Anchors")
+	int32 GetNumAnchors(EPhantoSemanticLabel Label = EPhantoSemanticLabel::Unknown) const;
+
+	/** Anchors with Label, every anchor for Unknown. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Anchors")
+	int32 GetAnchors(EPhantoSemanticLabel Label, TArray<UBlueprintXRSceneAnchorComponent*>& OutAnchors) const;
+
+	/** Anchors with Label whose bounds are within Radius of Location. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Anchors")
+	int32 GetAnchorsInRadius(EPhantoSemanticLabel Label, const FVector& Location, float Radius, TArray<UBlueprintXRSceneAnchorComponent*>& OutAnchors) const;
+
+	/** Anchor with Label whose bounds are the closest to Location, within MaxDistance when it is > 0. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Anchors")
+	UBlueprintXRSceneAnchorComponent* FindNearestAnchor(EPhantoSemanticLabel Label, const FVector& Location, float MaxDistance = 0) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Scene|Anchors")
+	bool GetAnchorData(const UBlueprintXRSceneAnchorComponent* Anchor, FPhantoSceneAnchorData& OutData) const;
+
+	/** Cached label of the anchor of Actor, Unknown when it has none. */
+	EPhantoSemanticLabel GetActorLabel(const AActor* Actor) const;
+
+	/** Incremented on every change, to tell whether data derived from the anchors is stale. */
+	uint32 GetVersion() const { return Version; }
+
+private:
+	TArray<TWeakObjectPtr<UBlueprintXRSceneAnchorComponent>> Anchors;
+	TArray<TWeakObjectPtr<const AActor>> Actors;
+	TArray<EPhantoSemanticLabel> Labels;
+	TArray<FBox> Bounds;
+	TArray<FPhantoSceneAnchorData> Data;
+
+	TMap<TWeakObjectPtr<const UBlueprintXRSceneAnchorComponent>, int32> Indices;
+	uint32 Version = 0;
+
+	void WriteRow(int32 Index, UBlueprintXRSceneAnchorComponent& Anchor);
+	void RemoveRow(int32 Index);
+};
@@ -0,0 +1,83 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPhantoSceneMeshData;
+
+struct FPhantoSceneBVHHit
+{
+	FVector Location = FVector::ZeroVector;
+
+	/** Face normal, on the side of the query. */
+	FVector Normal = FVector::ZeroVector;
+	float Distance = 0;
+
+	/** Index of the triangle in the mesh the BVH was built from. */
+	int32 Triangle = INDEX_NONE;
+};
+
+/**
+ * Bounding volume hierarchy over the triangles of the room, for queries that don't need the physics scene.
+ *
+ * Built top-down with binned SAH, the two halves of large nodes in parallel. Nodes are 32 bytes and flattened
+ * depth-first, so the left child of a node follows it and only the right child is stored. Leaves hold up to four
+ * triangles packed as one block of lanes (origin, edges and normal per axis), which each query tests at once with
+ * SIMD: ray intersection for raycasts, plane distance to cull triangles before the exact closest point test.
+ */
+struct PHANTO_API FPhantoSceneBVH
+{
+	struct FNode
+	{
+		FVector3f Min;
+
+		/** Right child of interior nodes, first triangle block of leaves. */
+		uint32 Data;
+		FVector3f Max;
+
+		/** Number of triangles, 0 for interior nodes. */
+		uint32 Count;
+	};
+
+	struct alignas(16) FTriangleBlock
+	{
+		float V0[3][4];
+		float E1[3][4];
+		float E2[3][4];
+		float N[3][4];
+
+		/** Triangle of each lane, INDEX_NONE for padding. */
+		int32 Triangles[4];
+	};
+
+	/** Builds over the triangles of Mesh, with at most MaxLeafTriangles (up to 4) per leaf. */
+	void Build(const FPhantoSceneMeshData& Mesh, int32 MaxLeafTriangles = 4);
+
+	bool IsEmpty() const { return Nodes.Num() == 0; }
+	FBox GetBounds() const;
+	int32 GetNumNodes() const { return Nodes.Num(); }
+	int32 GetNumTriangles() const { return NumTriangles; }
+	SIZE_T GetAllocatedSize() const { return Nodes.GetAllocatedSize() + Blocks.GetAllocatedSize(); }
+
+	/** First hit along the segment from Start to End, both faces count. Safe to call from any thread. */
+	bool Raycast(const FVector& Start, const FVector& End, FPhantoSceneBVHHit& OutHit) const;
+
+	/** Closest point of the mesh within MaxDistance of Point, any distance when MaxDistance <= 0. */
+	bool ClosestPoint(const FVector& Point, float MaxDistance, FPhantoSceneBVHHit& OutHit) const;
+
+	/** Appends the triangles touching the sphere. Returns how many were appended. */
+	int32 SphereOverlap(const FVector& Center, float Radius, TArray<int32>& OutTriangles) const;
+
+	/** Whether any triangle touches the sphere, stops at the first one. */
+	bool OverlapsSphere(const FVector& Center, float Radius) const;
+
+private:
+	TArray<FNode> Nodes;
+	TArray<FTriangleBlock> Blocks;
+	int32 NumTriangles = 0;
+
+	/** Visits the triangles closer than the running best squared distance to Point, nearest nodes first. */
+	template <typename FunctorType>
+	void ForEachTriangleNear(const FVector3f& Point, float& BestDistanceSquared, FunctorType&& Visitor) const;
+};
@@ -0,0 +1,57 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoSceneBVHSubsystem.generated.h"
+
+struct FPhantoSceneBVH;
+
+/**
+ * Triangle BVH of the scene mesh, for goo placement, spawn validation, line of sight and stream hits without going
+ * through the physics scene.
+ *
+ * Built when the scene is populated, from the scene actor and the anchors it spawned. Like the flight octree, the BVH
+ * is immutable once built and a rebuild swaps in a new one, so worker threads can keep querying their snapshot.
+ */
+UCLASS()
+class PHANTO_API UPhantoSceneBVHSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Whether Populate Scene Async builds the BVH, on the game thread, before reporting the scene populated. */
+	UPROPERTY(BlueprintReadWrite, Category = "Scene|BVH")
+	bool bBuildOnScenePopulated = false;
+
+	/** Builds the BVH over the triangles of Actors and of the actors attached to or owned by them. Returns the build time in milliseconds. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|BVH")
+	float BuildFromActors(const TArray<AActor*>& Actors);
+
+	UFUNCTION(BlueprintCallable, Category = "Scene|BVH")
+	void Clear();
+
+	UFUNCTION(BlueprintPure, Category = "Scene|BVH")
+	bool IsBuilt() const { return BVH.IsValid(); }
+
+	/** First hit of the scene mesh between Start and End. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|BVH")
+	bool Raycast(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal, float& OutDistance) const;
+
+	/** Closest point of the scene mesh within MaxDistance of Point, any distance when MaxDistance <= 0. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|BVH")
+	bool ClosestPoint(const FVector& Point, float MaxDistance, FVector& OutLocation, FVector& OutNormal, float& OutDistance) const;
+
+	UFUNCTION(BlueprintPure, Category = "Scene|BVH")
+	bool OverlapsSphere(const FVector& Center, float Radius) const;
+
+	/** Indices of the scene mesh triangles touching the sphere. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|BVH")
+	int32 SphereOverlap(const FVector& Center, float Radius, TArray<int32>& OutTriangles) const;
+
+	TSharedPtr<const FPhantoSceneBVH> GetBVH() const { return BVH; }
+
+private:
+	TSharedPtr<const FPhantoSceneBVH> BVH;
+};
@@ -0,0 +1,106 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhantoSceneTypes.h"
+
+class AActor;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Scene capture file (.phsc), a room recorded on device to replay it without a headset.
+ *
+ * Plain little-endian structs at 16 byte aligned offsets, so a mapped file is used in place: header, world space
+ * vertices (3 floats), triangle indices (uint32), anchors, then the UTF-8 classifications of the anchors as one
+ * string table. Every anchor, the scene mesh included, owns a contiguous range of the vertices and indices, so the
+ * whole file is also one triangle soup of the room.
+ */
+struct FPhantoSceneCaptureHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x43534850; // "PHSC"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	uint32 NumVertices = 0;
+	uint32 NumIndices = 0;
+	uint32 NumAnchors = 0;
+	uint32 NumStringBytes = 0;
+	uint64 VerticesOffset = 0;
+	uint64 IndicesOffset = 0;
+	uint64 AnchorsOffset = 0;
+	uint64 StringsOffset = 0;
+	uint64 Reserved = 0;
+};
+
+struct FPhantoSceneCaptureAnchor
+{
+	/** Actor transform, without scale: the vertices are captured world sized. */
+	float Location[3];
+	float Rotation[4];
+
+	/** Vertices and indices of the anchor, the indices are into the whole vertex array. */
+	uint32 FirstVertex;
+	uint32 NumVertices;
+	uint32 FirstIndex;
+	uint32 NumIndices;
+
+	/** Comma separated classifications in the string table. */
+	uint32 ClassificationsOffset;
+	uint32 ClassificationsLength;
+	uint8 Label;
+	uint8 Padding[3];
+	uint32 Reserved[2];
+
+	FTransform GetTransform() const;
+};
+
+static_assert(sizeof(FPhantoSceneCaptureHeader) == 64, "The capture header is part of the file format");
+static_assert(sizeof(FPhantoSceneCaptureAnchor) == 64, "Capture anchors are part of the file format");
+
+/** Read-only view of a capture file, memory mapped when the platform allows it. */
+class PHANTO_API FPhantoSceneCapture
+{
+public:
+	~FPhantoSceneCapture();
+
+	/** Opens and validates a capture. Returns null if the file is missing or malformed. */
+	static TUniquePtr<FPhantoSceneCapture> Open(const FString& Path);
+
+	const FPhantoSceneCaptureHeader& GetHeader() const { return *Header; }
+	TConstArrayView<FVector3f> GetVertices() const { return Vertices; }
+	TConstArrayView<uint32> GetIndices() const { return Indices; }
+	TConstArrayView<FPhantoSceneCaptureAnchor> GetAnchors() const { return Anchors; }
+	TArray<FString> GetClassifications(const FPhantoSceneCaptureAnchor& Anchor) const;
+
+private:
+	FPhantoSceneCapture() = default;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Copy of the file when it can't be mapped. */
+	TArray64<uint8> Loaded;
+
+	const FPhantoSceneCaptureHeader* Header = nullptr;
+	TConstArrayView<FVector3f> Vertices;
+	TConstArrayView<uint32> Indices;
+	TConstArrayView<FPhantoSceneCaptureAnchor> Anchors;
+	TConstArrayView<UTF8CHAR> Strings;
+
+	bool Initialize(const uint8* Data, int64 Size);
+};
+
+namespace PhantoSceneCapture
+{
+	/**
+	 * Writes the scene actors gathered from Roots to a capture file: one anchor per actor with an anchor component or
+	 * triangles. Returns false if there was nothing to capture or the file couldn't be written.
+	 */
+	PHANTO_API bool CaptureToFile(const TArray<AActor*>& Roots, const FString& Path);
+
+	/** Saved/SceneCaptures/<Prefix>_<date>.phsc */
+	PHANTO_API FString MakeCapturePath(const FString& Prefix = TEXT("Room"));
+}
@@ -0,0 +1,34 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UPrimitiveComponent;
+
+/** World space triangle soup of the room. */
+struct PHANTO_API FPhantoSceneMeshData
+{
+	TArray<FVector3f> Vertices;
+	TArray<uint32> Indices;
+
+	int32 GetNumTriangles() const { return Indices.Num() / 3; }
+	void Reset() { Vertices.Reset(); Indices.Reset(); }
+	FBox GetBounds() const;
+};
+
+namespace PhantoSceneGeometry
+{
+	/** Roots plus the actors attached to them or owned by them, as the scene actor owns the actors it spawns. */
+	PHANTO_API void GatherSceneActors(const TArray<AActor*>& Roots, TArray<AActor*>& OutActors);
+
+	/**
+	 * Appends the triangles of a component that collides with queries: procedural mesh sections, static mesh LOD 0
+	 * when the mesh allows CPU access, and otherwise the boxes and convexes of the static mesh collision.
+	 */
+	PHANTO_API void AppendComponentTriangles(const UPrimitiveComponent& Component, FPhantoSceneMeshData& Out);
+
+	/** Triangles of the scene actors gathered from Roots. */
+	PHANTO_API FPhantoSceneMeshData GatherTriangles(const TArray<AActor*>& Roots);
+}
@@ -0,0 +1,30 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhantoSceneTypes.generated.h"
+
+/** What a surface of the room is, from its scene anchor or, for the scene mesh, its orientation. */
+UENUM(BlueprintType)
+enum class EPhantoSemanticLabel : uint8
+{
+	Unknown,
+	Floor,
+	Wall,
+	Ceiling,
+	Furniture,
+	Door,
+	Window,
+};
+
+namespace PhantoScene
+{
+	constexpr int32 NumSemanticLabels = int32(EPhantoSemanticLabel::Window) + 1;
+
+	/** Label of the semantic classifications of a scene anchor, Unknown for the global mesh and unclassified anchors. */
+	PHANTO_API EPhantoSemanticLabel GetLabelFromClassifications(const TArray<FString>& Classifications);
+
+	/** Label of a scene mesh surface from its normal: up is floor, down is ceiling, anything else is wall. */
+	PHANTO_API EPhantoSemanticLabel GetLabelFromNormal(const FVector& Normal);
+}
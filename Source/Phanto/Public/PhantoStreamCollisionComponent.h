@@ -0,0 +1,110 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "Engine/HitResult.h"
+#include "WorldCollision.h"
+#include "PhantoStreamCollisionComponent.generated.h"
+
+class UDamageType;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPhantoStreamHit, const FHitResult&, Hit, float, DeltaSeconds);
+
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoStreamCollisionStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Stream")
+	int32 TracesPerFrame = 0;
+
+	/** Game thread time spent issuing and reading back the traces of the last frame. */
+	UPROPERTY(BlueprintReadOnly, Category = "Stream")
+	float TraceTimeMs = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Stream")
+	int32 Hits = 0;
+};
+
+/**
+ * Works out what the ecto stream hits, for the goo cleanup, enemy damage and stream visuals alike.
+ *
+ * While streaming, the component traces its whole ballistic arc each frame as one batch of async traces, and reads
+ * the results of that batch on the next frame. The first blocking hit along the arc cleans the goo splats around it,
+ * damages the actor hit and is broadcast to OnStreamHit.
+ */
+UCLASS(ClassGroup = (Phanto), meta = (BlueprintSpawnableComponent))
+class PHANTO_API UPhantoStreamCollisionComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPhantoStreamCollisionComponent();
+
+	/** Speed of the stream along the forward vector of the component. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream")
+	float LaunchSpeed = 600;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream")
+	float GravityScale = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream", meta = (ClampMin = "1", ClampMax = "64"))
+	int32 NumSegments = 12;
+
+	/** Flight time covered by the arc. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream", meta = (ClampMin = "0.01"))
+	float ArcDuration = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	/** Radius of goo cleaned around the hit, 0 to not clean. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream")
+	float CleanRadius = 20;
+
+	/** Damage applied to the actor hit, per second of streaming. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream")
+	float DamagePerSecond = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream")
+	TSubclassOf<UDamageType> DamageType;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnPhantoStreamHit OnStreamHit;
+
+	UFUNCTION(BlueprintCallable, Category = "Stream")
+	void SetStreaming(bool bInStreaming);
+
+	UFUNCTION(BlueprintPure, Category = "Stream")
+	bool IsStreaming() const { return bStreaming; }
+
+	/** Hit found by the traces of the previous frame. */
+	UFUNCTION(BlueprintPure, Category = "Stream")
+	bool GetLastHit(FHitResult& Hit) const;
+
+	/** Points of the arc traced this frame, ending at the last hit when there is one. */
+	UFUNCTION(BlueprintPure, Category = "Stream")
+	TArray<FVector> GetArcPoints() const { return ArcPoints; }
+
+	UFUNCTION(BlueprintPure, Category = "Stream")
+	FPhantoStreamCollisionStats GetStats() const { return Stats; }
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	bool bStreaming = false;
+	bool bHasHit = false;
+	FHitResult LastHit;
+
+	TArray<FVector> ArcPoints;
+	TArray<FTraceHandle> Traces;
+	FPhantoStreamCollisionStats Stats;
+
+	void ReadTraces(float DeltaSeconds);
+	void IssueTraces();
+};
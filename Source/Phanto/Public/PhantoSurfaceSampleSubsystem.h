@@ -0,0 +1,86 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhantoSceneTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoSurfaceSampleSubsystem.generated.h"
+
+/**
+ * Precomputed spawn points on the surfaces of the room, so spawning doesn't trace at random until it lands somewhere valid.
+ *
+ * After the scene is populated, its triangles are sampled into a Poisson-disk point cloud (random candidates weighted
+ * by area, each kept only if no kept point is within SampleSpacing), tagged with the surface normal and the label of
+ * their scene anchor, or of their orientation for the scene mesh. Anchor surfaces are sampled first so they win over
+ * the scene mesh where both overlap.
+ *
+ * Points are stored as parallel arrays sorted by label, which makes random picks of a label O(1), and indexed by a 3D
+ * grid in compressed row layout for radius queries.
+ */
+UCLASS()
+class PHANTO_API UPhantoSurfaceSampleSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Minimum distance between two points. */
+	UPROPERTY(BlueprintReadWrite, Category = "Scene|Surface Samples")
+	float SampleSpacing = 25;
+
+	/** Size of the cells of the spatial grid used by radius queries. */
+	UPROPERTY(BlueprintReadWrite, Category = "Scene|Surface Samples")
+	float GridCellSize = 100;
+
+	/** Seed of the sampling, the same room always gives the same points. */
+	UPROPERTY(BlueprintReadWrite, Category = "Scene|Surface Samples")
+	int32 Seed = 0;
+
+	/** Whether Populate Scene Async samples the scene, on the game thread, before reporting it populated. */
+	UPROPERTY(BlueprintReadWrite, Category = "Scene|Surface Samples")
+	bool bBuildOnScenePopulated = false;
+
+	/** Samples the surfaces of Actors and of the actors attached to or owned by them. Returns the number of points. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Surface Samples")
+	int32 BuildFromActors(const TArray<AActor*>& Actors);
+
+	UFUNCTION(BlueprintCallable, Category = "Scene|Surface Samples")
+	void Clear();
+
+	/** Number of points with Label, Unknown counts every point. */
+	UFUNCTION(BlueprintPure, Category = "Scene|Surface Samples")
+	int32 GetNumSurfacePoints(EPhantoSemanticLabel Label = EPhantoSemanticLabel::Unknown) const;
+
+	/** Random point with Label, any label for Unknown. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Surface Samples")
+	bool GetRandomSurfacePoint(EPhantoSemanticLabel Label, FVector& OutLocation, FVector& OutNormal) const;
+
+	/** Random point with Label at least MinDistance from Origin, e.g. a wall point away from the player. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Surface Samples")
+	bool FindSurfacePointAwayFrom(EPhantoSemanticLabel Label, const FVector& Origin, float MinDistance, FVector& OutLocation, FVector& OutNormal) const;
+
+	/** Random point with Label within MaxDistance of Origin. */
+	UFUNCTION(BlueprintCallable, Category = "Scene|Surface Samples")
+	bool FindSurfacePointNear(EPhantoSemanticLabel Label, const FVector& Origin, float MaxDistance, FVector& OutLocation, FVector& OutNormal) const;
+
+private:
+	TArray<FVector3f> Locations;
+	TArray<FVector3f> Normals;
+	TArray<EPhantoSemanticLabel> Labels;
+
+	/** First point and number of points of each label. */
+	FIntPoint LabelRanges[PhantoScene::NumSemanticLabels] = {};
+
+	/** The grid cell of a point is GridOrigin + (X, Y, Z) * GridCellSize; GridPoints[GridStarts[Cell]..GridStarts[Cell + 1]] are its points. */
+	FVector GridOrigin = FVector::ZeroVector;
+	FIntVector GridSize = FIntVector::ZeroValue;
+	TArray<int32> GridStarts;
+	TArray<int32> GridPoints;
+
+	FIntPoint GetRange(EPhantoSemanticLabel Label) const;
+	void BuildGrid();
+
+	/** Calls Visitor(PointIndex, DistanceSquared) for every point within Radius of Origin. */
+	template <typename FunctorType>
+	void ForEachPointInRadius(const FVector& Origin, float Radius, FunctorType&& Visitor) const;
+};
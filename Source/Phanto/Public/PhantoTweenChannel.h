@@ -0,0 +1,289 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhantoTweenChannel.generated.h"
+
+UENUM(BlueprintType)
+enum class EPhantoTweenEasing : uint8
+{
+	Linear,
+	EaseIn,
+	EaseOut,
+	EaseInOut,
+	SinusoidalInOut,
+};
+
+/** What a tween writes its value to every frame. */
+UENUM(BlueprintType)
+enum class EPhantoTweenTarget : uint8
+{
+	/** The value is only reported to the callback of the tween. */
+	None,
+	RelativeLocation,
+	WorldLocation,
+	RelativeRotation,
+	RelativeScale,
+	RelativeTransform,
+	/** Scalar or vector parameter of a dynamic material instance. */
+	MaterialParameter,
+	LightIntensity,
+	LightColor,
+};
+
+/** Identifies a tween in the pool of its channel; stale once the tween ends, even if its slot is reused. */
+USTRUCT(BlueprintType)
+struct PHANTO_API FPhantoTweenHandle
+{
+	GENERATED_BODY()
+
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+	uint8 Channel = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; }
+};
+
+struct FPhantoTweenBinding
+{
+	TWeakObjectPtr<UObject> Target;
+	FName Parameter;
+	EPhantoTweenTarget Kind = EPhantoTweenTarget::None;
+};
+
+namespace PhantoTween
+{
+	/** Maps a linear progress from 0 to 1 through the easing curve. */
+	PHANTO_API float Ease(EPhantoTweenEasing Easing, float Alpha);
+
+	inline float Interpolate(float A, float B, float Alpha) { return FMath::Lerp(A, B, Alpha); }
+	inline FVector Interpolate(const FVector& A, const FVector& B, float Alpha) { return FMath::Lerp(A, B, double(Alpha)); }
+	inline FLinearColor Interpolate(const FLinearColor& A, const FLinearColor& B, float Alpha) { return FMath::Lerp(A, B, Alpha); }
+	inline FQuat Interpolate(const FQuat& A, const FQuat& B, float Alpha) { return FQuat::Slerp(A, B, Alpha); }
+
+	inline FTransform Interpolate(const FTransform& A, const FTransform& B, float Alpha)
+	{
+		FTransform Result;
+		Result.Blend(A, B, Alpha);
+		return Result;
+	}
+
+	/** Writes Value to the target of Binding. Returns false once the target is gone. */
+	PHANTO_API bool Apply(const FPhantoTweenBinding& Binding, float Value);
+	PHANTO_API bool Apply(const FPhantoTweenBinding& Binding, const FVector& Value);
+	PHANTO_API bool Apply(const FPhantoTweenBinding& Binding, const FLinearColor& Value);
+	PHANTO_API bool Apply(const FPhantoTweenBinding& Binding, const FQuat& Value);
+	PHANTO_API bool Apply(const FPhantoTweenBinding& Binding, const FTransform& Value);
+}
+
+/**
+ * Pool of tweens of one value type.
+ *
+ * Tweens live in dense parallel arrays that are advanced in passes (progress, easing, interpolation, then writes to
+ * targets), each pass being a tight loop over contiguous data. Handles point to slots that map to the dense index,
+ * so tweens can be swapped out without invalidating the handles of the others.
+ *
+ * Tweens can be added and cancelled from callbacks; tweens added during Advance start on the next one.
+ */
+template <typename ValueType>
+class TPhantoTweenChannel
+{
+public:
+	/** Called with the current value, and true on the last call once the end value is reached. */
+	using FCallback = TDelegate<void(const ValueType&, bool)>;
+
+	explicit TPhantoTweenChannel(uint8 InChannel = 0)
+		: Channel(InChannel)
+	{
+	}
+
+	FPhantoTweenHandle Add(const ValueType& Start, const ValueType& End, float Duration, EPhantoTweenEasing Easing, const FPhantoTweenBinding& Binding, FCallback Callback = FCallback())
+	{
+		auto const Slot = FreeSlots.Num() > 0 ? FreeSlots.Pop(EAllowShrinking::No) : Slots.AddDefaulted();
+
+		FPhantoTweenHandle Handle;
+		Handle.Index = Slot;
+		Handle.Generation = Slots[Slot].Generation;
+		Handle.Channel = Channel;
+
+		FTween Tween{ Slot, Start, End, Duration, Easing, Binding, MoveTemp(Callback) };
+		if (bAdvancing)
+		{
+			Slots[Slot].Dense = PendingIndex;
+			Pending.Add(MoveTemp(Tween));
+		}
+		else
+		{
+			AddNow(MoveTemp(Tween));
+		}
+		return Handle;
+	}
+
+	bool IsActive(const FPhantoTweenHandle& Handle) const
+	{
+		if (Handle.Channel != Channel || !Slots.IsValidIndex(Handle.Index) || Slots[Handle.Index].Generation != Handle.Generation)
+			return false;
+
+		auto const Dense = Slots[Handle.Index].Dense;
+		return Dense == PendingIndex || (Dense != INDEX_NONE && !(Removed.IsValidIndex(Dense) && Removed[Dense]));
+	}
+
+	bool Cancel(const FPhantoTweenHandle& Handle)
+	{
+		if (!IsActive(Handle))
+			return false;
+
+		auto const Dense = Slots[Handle.Index].Dense;
+		if (Dense == PendingIndex)
+		{
+			Pending.RemoveAllSwap([&Handle](const FTween& Tween) { return Tween.Slot == Handle.Index; });
+			ReleaseSlot(Handle.Index);
+		}
+		else if (bAdvancing)
+		{
+			// Dense arrays can't be compacted while callbacks run, the tween is removed at the end of Advance.
+			Removed[Dense] = true;
+		}
+		else
+		{
+			RemoveDense(Dense);
+		}
+		return true;
+	}
+
+	void Advance(float DeltaTime)
+	{
+		auto const Count = DenseSlots.Num();
+		Alphas.SetNumUninitialized(Count, EAllowShrinking::No);
+		Values.SetNumUninitialized(Count, EAllowShrinking::No);
+		Completed.Init(false, Count);
+		Removed.Init(false, Count);
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Elapsed[i] += DeltaTime;
+			Alphas[i] = FMath::Min(Elapsed[i] * InvDurations[i], 1.f);
+		}
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Completed[i] = Alphas[i] >= 1;
+			Alphas[i] = PhantoTween::Ease(Easings[i], Alphas[i]);
+		}
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Values[i] = Completed[i] ? Ends[i] : PhantoTween::Interpolate(Starts[i], Ends[i], Alphas[i]);
+		}
+
+		bAdvancing = true;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (Bindings[i].Kind != EPhantoTweenTarget::None && !PhantoTween::Apply(Bindings[i], Values[i]))
+			{
+				Removed[i] = true;
+				continue;
+			}
+
+			if (!Removed[i])
+				Callbacks[i].ExecuteIfBound(Values[i], Completed[i]);
+		}
+		bAdvancing = false;
+
+		for (int32 i = Count - 1; i >= 0; --i)
+		{
+			if (Completed[i] || Removed[i])
+				RemoveDense(i);
+		}
+		Removed.Reset();
+
+		for (auto& Tween : Pending)
+		{
+			AddNow(MoveTemp(Tween));
+		}
+		Pending.Reset();
+	}
+
+	int32 Num() const { return DenseSlots.Num() + Pending.Num(); }
+
+	/** Number of slots allocated by the pool, active or free. */
+	int32 GetPoolSize() const { return Slots.Num(); }
+
+private:
+	static constexpr int32 PendingIndex = -2;
+
+	struct FSlot
+	{
+		int32 Dense = INDEX_NONE;
+		uint32 Generation = 0;
+	};
+
+	struct FTween
+	{
+		int32 Slot;
+		ValueType Start;
+		ValueType End;
+		float Duration;
+		EPhantoTweenEasing Easing;
+		FPhantoTweenBinding Binding;
+		FCallback Callback;
+	};
+
+	uint8 Channel;
+	TArray<FSlot> Slots;
+	TArray<int32> FreeSlots;
+
+	TArray<int32> DenseSlots;
+	TArray<ValueType> Starts;
+	TArray<ValueType> Ends;
+	TArray<float> Elapsed;
+	TArray<float> InvDurations;
+	TArray<EPhantoTweenEasing> Easings;
+	TArray<FPhantoTweenBinding> Bindings;
+	TArray<FCallback> Callbacks;
+
+	TArray<float> Alphas;
+	TArray<ValueType> Values;
+	TBitArray<> Completed;
+	TBitArray<> Removed;
+	TArray<FTween> Pending;
+	bool bAdvancing = false;
+
+	void AddNow(FTween&& Tween)
+	{
+		Slots[Tween.Slot].Dense = DenseSlots.Add(Tween.Slot);
+		Starts.Add(Tween.Start);
+		Ends.Add(Tween.End);
+		Elapsed.Add(0);
+		InvDurations.Add(Tween.Duration > KINDA_SMALL_NUMBER ? 1 / Tween.Duration : BIG_NUMBER);
+		Easings.Add(Tween.Easing);
+		Bindings.Add(MoveTemp(Tween.Binding));
+		Callbacks.Add(MoveTemp(Tween.Callback));
+	}
+
+	void RemoveDense(int32 Dense)
+	{
+		ReleaseSlot(DenseSlots[Dense]);
+
+		DenseSlots.RemoveAtSwap(Dense, EAllowShrinking::No);
+		Starts.RemoveAtSwap(Dense, EAllowShrinking::No);
+		Ends.RemoveAtSwap(Dense, EAllowShrinking::No);
+		Elapsed.RemoveAtSwap(Dense, EAllowShrinking::No);
+		InvDurations.RemoveAtSwap(Dense, EAllowShrinking::No);
+		Easings.RemoveAtSwap(Dense, EAllowShrinking::No);
+		Bindings.RemoveAtSwap(Dense, EAllowShrinking::No);
+		Callbacks.RemoveAtSwap(Dense, EAllowShrinking::No);
+
+		if (DenseSlots.IsValidIndex(Dense))
+			Slots[DenseSlots[Dense]].Dense = Dense;
+	}
+
+	void ReleaseSlot(int32 Slot)
+	{
+		Slots[Slot].Dense = INDEX_NONE;
+		++Slots[Slot].Generation;
+		FreeSlots.Add(Slot);
+	}
+};
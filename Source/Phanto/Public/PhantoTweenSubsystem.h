@@ -0,0 +1,90 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhantoTweenChannel.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhantoTweenSubsystem.generated.h"
+
+class ULightComponent;
+class UMaterialInstanceDynamic;
+class USceneComponent;
+
+/**
+ * Advances every active tween of the world once per frame, with game time.
+ *
+ * Tweens write directly to components, lights and materials, so animating them doesn't need a timeline or an async
+ * node per animation. The returned handles can be used to cancel them.
+ */
+UCLASS()
+class PHANTO_API UPhantoTweenSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPhantoTweenSubsystem();
+
+	/** Tweens the location of Component from where it is now. */
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenLocation(USceneComponent* Component, FVector Target, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::EaseInOut, bool bWorldSpace = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenRotation(USceneComponent* Component, FRotator Target, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::EaseInOut);
+
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenScale(USceneComponent* Component, FVector Target, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::EaseInOut);
+
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenTransform(USceneComponent* Component, FTransform Target, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::EaseInOut);
+
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenMaterialScalar(UMaterialInstanceDynamic* Material, FName Parameter, float Start, float End, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::Linear);
+
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenMaterialColor(UMaterialInstanceDynamic* Material, FName Parameter, FLinearColor Start, FLinearColor End, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::Linear);
+
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenLightIntensity(ULightComponent* Light, float End, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::Linear);
+
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	FPhantoTweenHandle TweenLightColor(ULightComponent* Light, FLinearColor End, float Duration, EPhantoTweenEasing Easing = EPhantoTweenEasing::Linear);
+
+	/** Stops a tween where it is; the handle is invalidated. */
+	UFUNCTION(BlueprintCallable, Category = "Tween")
+	void CancelTween(UPARAM(ref) FPhantoTweenHandle& Handle);
+
+	UFUNCTION(BlueprintPure, Category = "Tween")
+	bool IsTweenActive(const FPhantoTweenHandle& Handle) const;
+
+	UFUNCTION(BlueprintPure, Category = "Tween")
+	int32 GetNumActiveTweens() const;
+
+	TPhantoTweenChannel<float>& GetScalars() { return Scalars; }
+	TPhantoTweenChannel<FVector>& GetVectors() { return Vectors; }
+	TPhantoTweenChannel<FLinearColor>& GetColors() { return Colors; }
+	TPhantoTweenChannel<FQuat>& GetRotations() { return Rotations; }
+	TPhantoTweenChannel<FTransform>& GetTransforms() { return Transforms; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum EChannel : uint8
+	{
+		ScalarChannel,
+		VectorChannel,
+		ColorChannel,
+		RotationChannel,
+		TransformChannel,
+	};
+
+	TPhantoTweenChannel<float> Scalars;
+	TPhantoTweenChannel<FVector> Vectors;
+	TPhantoTweenChannel<FLinearColor> Colors;
+	TPhantoTweenChannel<FQuat> Rotations;
+	TPhantoTweenChannel<FTransform> Transforms;
+};
@@ -0,0 +1,28 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Batch vector math, four vectors per SIMD register.
+ *
+ * Inputs don't need to be normalized: lengths are folded into the dot products, and the cosines are clamped to
+ * [-1, 1] before acos. Angles involving a zero vector are 0.
+ */
+namespace PhantoVectorMath
+{
+	/** OutRadians[i] is the angle between A[i] and B[i]. All views must have the same size. */
+	PHANTO_API void AnglesBetween(TConstArrayView<FVector> A, TConstArrayView<FVector> B, TArrayView<float> OutRadians);
+
+	/** OutRadians[i] is the angle between Direction and Vectors[i]. */
+	PHANTO_API void AnglesTo(const FVector& Direction, TConstArrayView<FVector> Vectors, TArrayView<float> OutRadians);
+
+	/**
+	 * Appends to OutIndices the indices of the locations inside the cone of half angle HalfAngleRadians around Direction,
+	 * with its apex at Origin. Locations further than MaxDistance are rejected when MaxDistance is positive.
+	 * Returns the number of indices added.
+	 */
+	PHANTO_API int32 FindInCone(const FVector& Origin, const FVector& Direction, float HalfAngleRadians, float MaxDistance,
+		TConstArrayView<FVector> Locations, TArray<int32>& OutIndices);
+}
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/CancellableAsyncAction.h"
+#include "PhantoTweenSubsystem.h"
 #include "RotateToAction.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FRotateToActionOutputPin, FRotator, Rotator);
@@ -17,8 +18,8 @@ class PHANTO_API URotateToAction : public UCancellableAsyncAction
 	FRotator Start;
 	FRotator Target;
 	float Time;
-	double StartTime;
-	FTimerHandle TimerHandle;
+	EPhantoTweenEasing Easing;
+	FPhantoTweenHandle TweenHandle;
 
 public:
 	UPROPERTY(BlueprintAssignable)
@@ -28,8 +29,9 @@ public:
 	FRotateToActionOutputPin Completed;
 	
 	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContext"), Category = "AsyncNode")
-	static URotateToAction* RotateTo(UObject const * WorldContext, FRotator Start, FRotator Target, float Time);
+	static URotateToAction* RotateTo(UObject const * WorldContext, FRotator Start, FRotator Target, float Time, EPhantoTweenEasing Easing = EPhantoTweenEasing::Linear);
 
 	virtual void Activate() override;
 	virtual void Cancel() override;
+	virtual bool IsActive() const override;
 };